@@ -0,0 +1,74 @@
+/**
+ * @file AdjacencyBench.cpp
+ * @brief Insert/find throughput of the Vertex adjacency containers.
+ * @details Fills one adjacency per sampled vertex with the V - 1 neighbours of
+ * a complete graph (the shape of the Real-world graphs) and then looks every
+ * neighbour up again, comparing std::unordered_map with FlatMap.
+ * Usage: AdjacencyBench [<vertices> ...] (defaults to the graph1-3 sizes)
+ */
+
+#include "../src/Utils.h"
+#include "../src/data/FlatMap.hpp"
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/// Number of vertices whose adjacency is built per size
+#define SAMPLES 64
+
+template <typename Adj>
+void run(const std::string &name, const std::vector<uint64_t> &keys,
+         const std::vector<uint64_t> &lookups) {
+  std::vector<Adj> adjs(SAMPLES);
+  Clock c;
+
+  c.start();
+  for (Adj &adj : adjs)
+    for (uint32_t i = 0; i < keys.size(); ++i)
+      adj[keys[i]] = i;
+  c.stop();
+  double insertTime = c.getTime();
+
+  uint64_t checksum = 0;
+  c.start();
+  for (Adj &adj : adjs)
+    for (uint64_t k : lookups)
+      checksum += adj.find(k)->second;
+  c.stop();
+  double findTime = c.getTime();
+
+  double ops = (double) SAMPLES * keys.size() / 1000.0; // per ms -> Mops/s
+  std::cout << "  " << std::left << std::setw(20) << name << std::right
+            << std::fixed << std::setprecision(1) << std::setw(10)
+            << ops / insertTime << " Minsert/s" << std::setw(10)
+            << ops / findTime << " Mfind/s   (checksum " << checksum << ")\n";
+}
+
+int main(int argc, char **argv) {
+  std::vector<uint64_t> sizes = {1000, 5000, 10000};
+  if (argc > 1) {
+    sizes.clear();
+    for (int i = 1; i < argc; ++i)
+      sizes.push_back(std::stoull(argv[i]));
+  }
+
+  std::mt19937_64 rng(42);
+  for (uint64_t v : sizes) {
+    std::vector<uint64_t> keys(v - 1);
+    std::iota(keys.begin(), keys.end(), 1);
+    std::shuffle(keys.begin(), keys.end(), rng);
+    std::vector<uint64_t> lookups = keys;
+    std::shuffle(lookups.begin(), lookups.end(), rng);
+
+    std::cout << v << " vertices (" << SAMPLES << " adjacencies of " << v - 1
+              << " edges):\n";
+    run<std::unordered_map<uint64_t, uint32_t>>("std::unordered_map", keys,
+                                                lookups);
+    run<FlatMap<uint64_t, uint32_t>>("FlatMap", keys, lookups);
+  }
+}
@@ -0,0 +1,98 @@
+/**
+ * @file DistanceBench.cpp
+ * @brief Throughput of the one-to-many great-circle distance kernels.
+ * @details Computes rows of distances from sampled vertices to every vertex
+ * of a set of random coordinates, comparing Utils::haversineDistance on the
+ * Info coordinates with the DistanceKernel rows (scalar and AVX2). Also
+ * reports the largest difference between the kernel and the haversine.
+ * Usage: DistanceBench [<vertices> ...] (defaults to the graph1-3 sizes)
+ */
+
+#include "../src/Utils.h"
+#include "../src/data/DistanceKernel.h"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+/// Number of rows computed per size
+#define SAMPLES 64
+
+/// Runs fn(source, row) for SAMPLES sources and prints the throughput
+void run(const std::string &name, uint32_t n, std::vector<double> &row,
+         const std::function<void(uint32_t, double *)> &fn) {
+  double checksum = 0;
+  Clock c;
+  c.start();
+  for (uint32_t s = 0; s < SAMPLES; ++s) {
+    fn(s * (n / SAMPLES), row.data());
+    checksum += row[s];
+  }
+  c.stop();
+  double ops = (double) SAMPLES * n / 1000.0; // per ms -> Mops/s
+  std::cout << "  " << std::left << std::setw(24) << name << std::right
+            << std::fixed << std::setprecision(1) << std::setw(10)
+            << ops / c.getTime() << " Mdist/s   (checksum "
+            << std::setprecision(0) << checksum << ")\n";
+}
+
+int main(int argc, char **argv) {
+  std::vector<uint32_t> sizes = {1000, 5000, 10000};
+  if (argc > 1) {
+    sizes.clear();
+    for (int i = 1; i < argc; ++i)
+      sizes.push_back(std::stoul(argv[i]));
+  }
+  std::cout << "AVX2 " << (DistanceKernel::hasAVX2() ? "available" : "unavailable")
+            << "\n";
+
+  std::mt19937_64 rng(42);
+  std::uniform_real_distribution<double> latDist(-80, 80), lonDist(-180, 180);
+  for (uint32_t n : sizes) {
+    std::vector<Info> infos;
+    std::vector<double> x(n), y(n), z(n), row(n);
+    for (uint32_t i = 0; i < n; ++i) {
+      infos.emplace_back(i, latDist(rng), lonDist(rng));
+      DistanceKernel::toUnitVector(infos[i].getLat().value(),
+                                   infos[i].getLon().value(), x[i], y[i], z[i]);
+    }
+
+    std::cout << n << " vertices (" << SAMPLES << " rows):\n";
+    run("haversineDistance", n, row, [&](uint32_t s, double *out) {
+      for (uint32_t i = 0; i < n; ++i)
+        out[i] = Utils::haversineDistance(
+            infos[s].getLat().value(), infos[s].getLon().value(),
+            infos[i].getLat().value(), infos[i].getLon().value());
+    });
+    run("distance row (scalar)", n, row, [&](uint32_t s, double *out) {
+      DistanceKernel::chordRowScalar(x[s], y[s], z[s], x.data(), y.data(),
+                                     z.data(), n, out);
+      for (uint32_t i = 0; i < n; ++i)
+        out[i] = DistanceKernel::chordToDistance(out[i]);
+    });
+    run("distance row", n, row, [&](uint32_t s, double *out) {
+      DistanceKernel::distanceRow(x[s], y[s], z[s], x.data(), y.data(),
+                                  z.data(), n, out);
+    });
+    run("chord row (scalar)", n, row, [&](uint32_t s, double *out) {
+      DistanceKernel::chordRowScalar(x[s], y[s], z[s], x.data(), y.data(),
+                                     z.data(), n, out);
+    });
+    run("chord row", n, row, [&](uint32_t s, double *out) {
+      DistanceKernel::chordRow(x[s], y[s], z[s], x.data(), y.data(), z.data(),
+                               n, out);
+    });
+
+    double maxError = 0;
+    DistanceKernel::distanceRow(x[0], y[0], z[0], x.data(), y.data(), z.data(),
+                                n, row.data());
+    for (uint32_t i = 0; i < n; ++i)
+      maxError = std::max(maxError, std::abs(row[i] - infos[0].distance(infos[i])));
+    std::cout << "  largest difference to the haversine: " << std::scientific
+              << std::setprecision(2) << maxError << " m\n";
+  }
+}
@@ -0,0 +1,47 @@
+/**
+ * @file HeldKarpBench.cpp
+ * @brief Scaling of the Held-Karp algorithm with the number of threads.
+ * @details Loads a graph and solves it with 1, 2, 4, ... threads, up to the
+ * given maximum (by default, the number of cores), printing the time, the
+ * speedup over one thread and the parallel efficiency of each.
+ * Usage: HeldKarpBench <edges.csv> [<nodes.csv>] [<max threads>]
+ */
+
+#include "../src/Utils.h"
+#include "../src/data/Data.h"
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+
+int main(int argc, char **argv) {
+  if (argc < 2) {
+    std::cerr << "USAGE: HeldKarpBench <edges.csv> [<nodes.csv>] [<max threads>]\n";
+    return 1;
+  }
+  std::string nodes = argc > 2 ? argv[2] : "";
+  unsigned maxThreads = argc > 3 ? std::stoul(argv[3])
+                                 : std::max(1u, std::thread::hardware_concurrency());
+  Data d(argv[1], nodes, 1);
+
+  uint32_t n = d.getCSR().getNumVertex();
+  std::cout << n << " vertices, " << (HeldKarp::memory(n) >> 20) + 1
+            << " MB, " << std::thread::hardware_concurrency() << " cores:\n";
+
+  double single = 0;
+  for (unsigned threads = 1; threads <= maxThreads; threads *= 2) {
+    d.setThreads(threads);
+    Clock c;
+    c.start();
+    std::optional<TSPResult> res = d.heldKarp(UINT64_MAX);
+    c.stop();
+    if (threads == 1)
+      single = c.getTime();
+    std::cout << "  " << std::setw(3) << threads << " threads" << std::fixed
+              << std::setprecision(1) << std::setw(12) << c.getTime() << " ms"
+              << std::setprecision(2) << std::setw(8) << single / c.getTime()
+              << "x" << std::setprecision(0) << std::setw(6)
+              << 100 * single / c.getTime() / threads << "%   cost "
+              << std::setprecision(1) << res->cost << "\n";
+  }
+}
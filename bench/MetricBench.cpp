@@ -0,0 +1,81 @@
+/**
+ * @file MetricBench.cpp
+ * @brief Speedup of the solvers specialized on the Metric of the graph.
+ * @details Loads a graph and times every solver with the DistanceOracle
+ * (which decides how to weight a pair on every lookup) and with the Metric
+ * instantiation Data picked for the graph. Backtracking only runs on graphs
+ * small enough to finish.
+ * Usage: MetricBench [--planar] <edges.csv> [<nodes.csv>] [<repetitions>]
+ */
+
+#include "../src/Utils.h"
+#include "../src/data/Data.h"
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+/// Largest graph the backtracking runs on
+#define BACKTRACKING_VERTICES 12
+
+/// Minimum time (in ms) of a measurement: short solvers are run repeatedly
+#define MIN_MEASUREMENT 50
+
+/// Best time of one run of fn, in ms, over a number of measurements
+double best(unsigned repetitions, const std::function<void()> &fn) {
+  double res = INF;
+  Clock c;
+  for (unsigned i = 0; i < repetitions; ++i) {
+    uint64_t runs = 0;
+    c.start();
+    do {
+      fn();
+      ++runs;
+      c.stop();
+    } while (c.getTime() < MIN_MEASUREMENT);
+    res = std::min(res, c.getTime() / runs);
+  }
+  return res;
+}
+
+int main(int argc, char **argv) {
+  bool planar = argc > 1 && std::string(argv[1]) == "--planar";
+  if (planar) {
+    --argc;
+    ++argv;
+  }
+  if (argc < 2) {
+    std::cerr << "USAGE: MetricBench [--planar] <edges.csv> [<nodes.csv>] "
+                 "[<repetitions>]\n";
+    return 1;
+  }
+  std::string nodes = argc > 2 ? argv[2] : "";
+  unsigned repetitions = argc > 3 ? std::stoul(argv[3]) : 5;
+  Data d(argv[1], nodes, 1);
+  d.setPlanar(planar);
+
+  const char *metrics[] = {"none", "haversine", "euclidean"};
+  std::cout << d.getCSR().getNumVertex() << " vertices, "
+            << d.getCSR().getNumEdges() << " edges, "
+            << (d.getMatrix() ? "matrix" : "sparse") << " + "
+            << metrics[(int) d.getImplicitMetric()] << ":\n";
+
+  std::vector<std::pair<std::string, std::function<void()>>> solvers = {
+      {"triangular", [&] { d.triangular(); }},
+      {"heuristic", [&] { d.heuristic(); }},
+  };
+  if (d.getCSR().getNumVertex() <= BACKTRACKING_VERTICES)
+    solvers.emplace_back("backtracking", [&] { d.backtracking(); });
+
+  for (auto &[name, fn] : solvers) {
+    d.setSpecialized(false);
+    double oracle = best(repetitions, fn);
+    d.setSpecialized(true);
+    double metric = best(repetitions, fn);
+    std::cout << "  " << std::left << std::setw(14) << name << std::right
+              << std::fixed << std::setprecision(4) << std::setw(12) << oracle
+              << " ms oracle" << std::setw(12) << metric << " ms metric"
+              << std::setprecision(2) << std::setw(8) << oracle / metric
+              << "x\n";
+  }
+}
@@ -0,0 +1,123 @@
+/**
+ * @file ParseBench.cpp
+ * @brief Throughput and allocations of the csv grammar.
+ * @details Runs every line of an edges.csv through the parse_line() grammar
+ * (the path taken by lines the tokenizer cannot split by hand), through
+ * CsvTokenizer and through the typed CsvReader, counting the heap allocations
+ * made per line.
+ * Usage: ParseBench [<edges.csv>] (defaults to a generated file shaped like
+ * the graph1 edges: 1000 vertices, complete, 499500 lines)
+ */
+
+#include "../src/CSV.hpp"
+#include "../src/Utils.h"
+#include "../src/data/MappedFile.h"
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <random>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/// Number of vertices of the generated file
+#define VERTICES 1000
+
+static uint64_t allocations = 0;
+
+void *operator new(size_t size) {
+  ++allocations;
+  if (void *ptr = std::malloc(size ? size : 1))
+    return ptr;
+  throw std::bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+
+void operator delete(void *ptr, size_t) noexcept { std::free(ptr); }
+
+/// Contents of an edges.csv of a complete graph, with a header
+std::string generate() {
+  std::mt19937_64 rng(42);
+  std::uniform_real_distribution<double> dist(1000, 900000);
+  std::ostringstream out;
+  out << "origem,destino,haversine_distance\n" << std::fixed
+      << std::setprecision(2);
+  for (uint32_t i = 0; i < VERTICES; ++i)
+    for (uint32_t j = i + 1; j < VERTICES; ++j)
+      out << i << ',' << j << ',' << dist(rng) << '\n';
+  return out.str();
+}
+
+/// Prints the throughput of one run over the file
+void report(const std::string &name, double ms, uint64_t lines,
+            uint64_t bytes, uint64_t allocs, double checksum) {
+  std::cout << "  " << std::left << std::setw(12) << name << std::right
+            << std::fixed << std::setprecision(2) << std::setw(8)
+            << lines / ms / 1000.0 << " Mlines/s" << std::setw(8)
+            << bytes / ms / 1000.0 << " MB/s" << std::setprecision(2)
+            << std::setw(8) << (double) allocs / lines
+            << " allocs/line   (checksum " << std::setprecision(0)
+            << checksum << ")\n";
+}
+
+int main(int argc, char **argv) {
+  std::string contents;
+  if (argc > 1) {
+    MappedFile file(argv[1]);
+    contents = file.view();
+  } else {
+    contents = generate();
+  }
+
+  std::vector<std::string_view> lines;
+  for (size_t pos = 0; pos < contents.size();) {
+    size_t end = contents.find('\n', pos);
+    if (end == std::string::npos)
+      end = contents.size();
+    lines.push_back(std::string_view(contents).substr(pos, end - pos));
+    pos = end + 1;
+  }
+  std::cout << lines.size() << " lines, " << contents.size() / 1000
+            << " KB:\n";
+
+  Clock c;
+  constexpr auto parser = parse_line().to_fn();
+  double checksum = 0;
+  uint64_t before = allocations;
+  c.start();
+  for (std::string_view line : lines) {
+    parsum::StringInput input(line);
+    auto res = parser(input);
+    if (res.has_val)
+      checksum += res.ok.get_data().back().get_flt().value_or(0);
+  }
+  c.stop();
+  report("parse_line", c.getTime(), lines.size(), contents.size(),
+         allocations - before, checksum);
+
+  checksum = 0;
+  before = allocations;
+  c.start();
+  CsvTokenizer tokenizer(contents);
+  std::vector<CsvValues> line;
+  while (tokenizer.next(line))
+    checksum += line.back().get_flt().value_or(0);
+  c.stop();
+  report("CsvTokenizer", c.getTime(), lines.size(), contents.size(),
+         allocations - before, checksum);
+
+  checksum = 0;
+  before = allocations;
+  c.start();
+  CsvReader<uint64_t, uint64_t, double> reader(contents);
+  while (reader.next() != decltype(reader)::End)
+    ;
+  for (double w : reader.column<2>())
+    checksum += w;
+  c.stop();
+  report("CsvReader", c.getTime(), lines.size(), contents.size(),
+         allocations - before, checksum);
+}
@@ -4,35 +4,85 @@
  * @details Checks the validity of the arguments and starts the program.
  */
 
+#include <algorithm>
 #include <filesystem>
 #include <iostream>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
 
 #include "src/Runtime.h"
 #include "src/Utils.h"
 #include "src/data/Data.h"
+#include "src/data/Snapshot.h"
 
 void printError() {
-  std::cerr << "USAGE: DA2324_PRJ2_G163 <edges.csv> [<nodes.csv>] \n"
+  std::cerr << "USAGE: DA2324_PRJ2_G163 [--threads <n>] [--candidates <k>] "
+               "[--planar] [--write-snapshot <graph.snap>] <edges.csv> "
+               "[<nodes.csv>] \n"
+            << "       DA2324_PRJ2_G163 [--threads <n>] [--planar] "
+               "<graph.snap> [<edges.csv> [<nodes.csv>]]\n"
             << "       being <edges.csv> the path to the csv file containing "
                "the edges\n"
             << "       and [<nodes.csv>] an optional path to the csv files "
                "about the nodes.\n"
+            << "       --threads <n> sets the number of threads parsing the "
+               "edges and running held-karp\n"
+            << "       (defaults to the number of cores).\n"
+            << "       --candidates <k> streams the edges, keeping only the k "
+               "lightest edges of every vertex,\n"
+            << "       so huge edge files fit in memory (meant for the "
+               "heuristic; needs <nodes.csv>).\n"
+            << "       --planar reads the coordinates in nodes.csv as planar "
+               "(x, y) coordinates\n"
+            << "       instead of latitudes and longitudes.\n"
+            << "       --write-snapshot <graph.snap> saves the parsed graph "
+               "to a binary snapshot,\n"
+            << "       which can be given instead of the csv files to skip "
+               "parsing them.\n"
+            << "       If the csv files are given after the snapshot, they "
+               "are only parsed when\n"
+            << "       the snapshot was not built from them (checked by "
+               "their checksum).\n"
             << "See the Doxygen documentation for more information.\n";
   std::exit(1);
 }
 
-bool isFile(const std::string &path) {
+bool hasExtension(const std::string &path, const std::string &extension) {
+  return path.substr(path.find_last_of('.') + 1) == extension;
+}
+
+bool isFile(const std::string &path, const std::string &extension = "csv") {
   if (!std::filesystem::is_regular_file(path)) {
     error("The path provided is not a file (" + path + ")");
     return false;
-  } else if (path.substr(path.find_last_of('.') + 1) != "csv") {
-    error("The file provided is not a csv file (" + path + ")");
+  } else if (!hasExtension(path, extension)) {
+    error("The file provided is not a " + extension + " file (" + path + ")");
     return false;
   }
   return true;
 }
 
-void startProgram(Data &d, Clock &c) {
+void writeSnapshot(const Data &d, const std::string &path,
+                   const std::vector<std::string> &files) {
+  if (d.writeSnapshot(path, Snapshot::checksum(files)))
+    info("Snapshot written to " + path);
+  else
+    error("Failed to write the snapshot to " + path);
+}
+
+void startProgram(Data &d, Clock &c, unsigned threads, bool planar) {
+  d.setThreads(threads);
+  d.setPlanar(planar);
+  // The heuristic falls back to the coordinates once every candidate of a
+  // vertex was visited
+  if (d.getCandidates() > 0 && !d.getCSR().isComplete() &&
+      d.getImplicitMetric() == ImplicitMetric::None) {
+    error("The candidate graph has no coordinates to fall back to, give a "
+          "nodes.csv file with them");
+    printError();
+  }
   Runtime rt(&d);
   c.stop();
   std::ostringstream oss;
@@ -41,25 +91,92 @@ void startProgram(Data &d, Clock &c) {
   rt.run();
 }
 
+/// Parses the value of a numeric option, which must be a positive integer
+unsigned positiveOption(const std::string &name, const char *value) {
+  unsigned res = 0;
+  try {
+    res = std::stoul(value);
+  } catch (std::exception &) {
+  }
+  if (res == 0) {
+    error("The " + name + " must be a positive integer");
+    printError();
+  }
+  return res;
+}
+
 int main(int argc, char **argv) {
-  if (argc < 2 || argc > 3) {
+  unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+  uint32_t candidates = 0;
+  bool planar = false;
+  std::string snapshot;
+  std::vector<std::string> files;
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    if (arg == "--write-snapshot" && i + 1 < argc) {
+      snapshot = argv[++i];
+    } else if (arg == "--threads" && i + 1 < argc) {
+      threads = positiveOption("number of threads", argv[++i]);
+    } else if (arg == "--planar") {
+      planar = true;
+    } else if (arg == "--candidates" && i + 1 < argc) {
+      candidates = positiveOption("number of candidates", argv[++i]);
+    } else {
+      files.push_back(arg);
+    }
+  }
+
+  bool fromSnapshot = !files.empty() && snapshot.empty() &&
+                      hasExtension(files[0], "snap");
+  if (files.empty() || files.size() > (fromSnapshot ? 3 : 2)) {
     for (int i = 0; i < argc; i++) {
       std::cout << argv[i] << std::endl;
     }
     printError();
   }
-  if (!isFile(argv[1]))
-    printError();
 
   Clock c;
   c.start();
-  if (argc == 2 || std::string(argv[2]).empty()) {
-    Data d(argv[1]);
-    startProgram(d, c);
+  if (fromSnapshot) {
+    if (!isFile(files[0], "snap"))
+      printError();
+    uint64_t checksum;
+    std::optional<Data> d = Data::fromSnapshot(files[0], &checksum);
+    if (!d.has_value()) {
+      error("The file provided is not a valid snapshot (" + files[0] + ")");
+      printError();
+    }
+    // If the csv files are given too, the snapshot must have been built from
+    // them
+    files.erase(files.begin());
+    for (const std::string &file : files)
+      if (!isFile(file))
+        printError();
+    if (files.empty() || Snapshot::checksum(files) == checksum) {
+      startProgram(d.value(), c, threads, planar);
+      return 0;
+    }
+    warning("The snapshot was not built from these csv files, parsing them "
+            "instead.");
+  }
+
+  if (!isFile(files[0]))
+    printError();
+  if (candidates > 0 && (files.size() == 1 || files[1].empty())) {
+    error("--candidates needs the coordinates in a nodes.csv file");
+    printError();
+  }
+  if (files.size() == 1 || files[1].empty()) {
+    Data d(files[0], threads, candidates);
+    if (!snapshot.empty())
+      writeSnapshot(d, snapshot, {files[0]});
+    startProgram(d, c, threads, planar);
   } else {
-    if (!isFile(argv[2]))
+    if (!isFile(files[1]))
       printError();
-    Data d(argv[1], argv[2]);
-    startProgram(d, c);
+    Data d(files[0], files[1], threads, candidates);
+    if (!snapshot.empty())
+      writeSnapshot(d, snapshot, files);
+    startProgram(d, c, threads, planar);
   }
 }
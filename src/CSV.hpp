@@ -3,11 +3,20 @@
 #define PARSUM_IMPL
 
 #include "Parsum.hpp"
+#include <algorithm>
 #include <cctype>
+#include <charconv>
 #include <cstddef>
 #include <cstdint>
+#include <exception>
+#include <istream>
 #include <optional>
 #include <string>
+#include <string_view>
+#include <system_error>
+#include <tuple>
+#include <type_traits>
+#include <utility>
 #include <variant>
 #include <vector>
 
@@ -200,45 +209,51 @@ consteval auto parse_weird();
 
 consteval auto parse_sep();
 
+/*
+ * @brief Converts the whole of a numeric field.
+ * @details Throws if the field is not a number, failing the parser that
+ * called it, the same way std::stoll/std::stod did.
+ * @note O(n), where n is the length of the field.
+ */
+template <typename T> T to_number(std::string_view text) {
+  T res;
+  auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), res);
+  if (ec != std::errc() || ptr != text.data() + text.size())
+    throw std::exception();
+  return res;
+}
+
 consteval auto parse_int() {
   constexpr auto parser = parsum::map(
-          maybe(parsum::char_p<std::string>('-')) + parsum::digits1(),
-          [](auto inp) -> CsvValues { return CsvValues::Int(std::stoll(inp)); });
-  return context(parser, [](auto err) {
-    return parsum::ParseError("Failed to parse int: " + err.get_why(),
-                              err.get_kind(), err.get_pos());
-  });
+          parsum::recognize(maybe(parsum::char_p('-')) >> parsum::digits1()),
+          [](std::string_view inp) -> CsvValues {
+            return CsvValues::Int(to_number<int64_t>(inp));
+          });
+  return parsum::label(parser, "Failed to parse int");
 }
 
 consteval auto parse_flt() {
   constexpr auto parser =
-          parsum::maybe(parsum::char_p<std::string>('-')) >> parsum::digits1() >>
-                                                          parsum::char_p<std::string>('.') >> parsum::digits1() >>
-                                                          parsum::cut(
-                                                                  parsum::peek(parsum::verify(
-                                                                          [](char const &c) { return c != '.'; })));
+          parsum::recognize(parsum::maybe(parsum::char_p('-')) >> parsum::digits1() >>
+                                                              parsum::char_p('.') >> parsum::digits1()) >>
+                                                              parsum::cut(
+                                                                      parsum::peek(parsum::verify(
+                                                                              [](char const &c) { return c != '.'; })) |
+                                                                      parsum::eof());
   constexpr auto result = map(parser, [](auto inp) -> CsvValues {
-    auto [sign, fst, sep, snd] = inp;
-    return CsvValues::Flt(std::stod(sign + fst + sep + snd));
-  });
-  return parsum::context(result, [](auto err) {
-    return parsum::ParseError("Failed to parse flt: " + err.get_why(),
-                              err.get_kind(), err.get_pos());
+    auto [text] = inp;
+    return CsvValues::Flt(to_number<double>(text));
   });
+  return parsum::label(result, "Failed to parse flt");
 }
 
 consteval auto parse_str() {
-  constexpr auto fst = parsum::map(parsum::verify([](char const &c) {
-                                     return c != ',' && c != '\n' && c != '\r';
-                                   }),
-                                   [](auto c) { return std::string{c}; });
-  constexpr auto parser = parsum::many1(fst);
-  constexpr auto result =
-          parsum::map(parser, [](auto inp) { return CsvValues::Str(inp); });
-  return parsum::context(result, [](auto err) {
-    return parsum::ParseError("Failed to parse str: " + err.get_why(),
-                              err.get_kind(), err.get_pos());
+  constexpr auto parser = parsum::take_while1([](char const &c) {
+    return c != ',' && c != '\n' && c != '\r';
   });
+  constexpr auto result = parsum::map(
+          parser, [](std::string_view inp) { return CsvValues::Str(std::string(inp)); });
+  return parsum::label(result, "Failed to parse str");
 }
 
 consteval auto parse_weird() {
@@ -247,46 +262,38 @@ consteval auto parse_weird() {
   constexpr auto parser = parse_quot >> parsum::digits1() >> parse_comm >>
                                      parsum::digits1() >> parse_quot;
   constexpr auto result = parsum::map(
-          parser, [](std::tuple<char, std::string, char, std::string, char> t) {
+          parser, [](std::tuple<char, std::string_view, char, std::string_view, char> t) {
             auto [_1, p1, _2, p2, _3] = t;
-            return CsvValues::Int(std::stoll(p1 + p2));
+            int64_t scale = 1;
+            for (size_t i = 0; i < p2.size(); ++i)
+              scale *= 10;
+            return CsvValues::Int(to_number<int64_t>(p1) * scale +
+                                  to_number<int64_t>(p2));
           });
-  return parsum::context(result, [](auto err) {
-    return parsum::ParseError("Failed to parse weird: " + err.get_why(),
-                              err.get_kind(), err.get_pos());
-  });
+  return parsum::label(result, "Failed to parse weird");
 }
 
 consteval auto parse_sep() {
   constexpr auto result =
           parsum::map(parsum::char_p(','), [](auto c) { return std::tuple(); });
-  return parsum::context(result, [](auto err) {
-    return parsum::ParseError("Failed to parse flt: " + err.get_why(),
-                              err.get_kind(), err.get_pos());
-  });
+  return parsum::label(result, "Failed to parse sep");
 }
 
 consteval auto parse_line() {
   using parsum::char_p;
-  constexpr auto parse_bom = parsum::context(
+  constexpr auto parse_bom = parsum::label(
           parsum::map(char_p('\xEF') >> char_p('\xBB') >> char_p('\xBF'),
                       [](auto) { return std::tuple(); }),
-          [](auto err) {
-            return parsum::ParseError("BOM: " + err.get_why(), err.get_kind(),
-                                      err.get_pos());
-          });
-  constexpr auto parse_val = parsum::context(
-          parse_flt() | parse_int() | parse_weird() | parse_str(), [](auto err) {
-            return parsum::ParseError("No valid alternatives found!",
-                                      err.get_kind(), err.get_pos());
-          });
-  constexpr auto parse_endl = parsum::context(
-          parsum::map(many0(char_p<std::string>('\r') | char_p<std::string>('\n')),
-                      [](std::string const &) { return std::tuple(); }),
-          [](auto err) {
-            return parsum::ParseError("Newline: " + err.get_why(), err.get_kind(),
-                                      err.get_pos());
-          });
+          "BOM");
+  constexpr auto parse_val = parsum::label(
+          parse_flt() | parse_int() | parse_weird() | parse_str(),
+          "Failed to parse value");
+  constexpr auto parse_endl = parsum::label(
+          parsum::map(parsum::take_while0([](char const &c) {
+                        return c == '\r' || c == '\n';
+                      }),
+                      [](std::string_view) { return std::tuple(); }),
+          "Newline");
   constexpr auto parser =
           parsum::maybe(parse_bom) >>
                                    many1(parsum::map(parse_val >> maybe(parse_sep()),
@@ -297,10 +304,7 @@ consteval auto parse_line() {
     CsvLine res(pp);
     return res;
   });
-  return parsum::context(result, [](auto err) {
-    return parsum::ParseError("Failed to parse line: " + err.get_why(),
-                              err.get_kind(), err.get_pos());
-  });
+  return parsum::label(result, "Failed to parse line");
 }
 
 consteval auto parse_csv() {
@@ -312,10 +316,7 @@ consteval auto parse_csv() {
     auto [head, data] = c;
     return Csv(head, data);
   });
-  return parsum::context(result, [](auto err) {
-    return parsum::ParseError("Could not parse CSV: " + err.get_why(),
-                              err.get_kind(), err.get_pos());
-  });
+  return parsum::label(result, "Could not parse CSV");
 }
 
 inline std::optional<std::string> CsvValues::get_str() const {
@@ -348,4 +349,275 @@ inline std::optional<double> CsvValues::get_flt() const {
   }
 }
 
+/*
+ * @brief Splits a buffer with the contents of a csv file into lines.
+ * @details Lines whose fields are all plain numbers (the bulk of edges.csv and
+ * nodes.csv) are split by hand and converted with std::from_chars, straight
+ * from the buffer. Any other line (headers, labels, quoted numbers, ...) is
+ * handed to the parse_line() grammar.
+ */
+class CsvTokenizer {
+private:
+  /// The whole file
+  std::string_view buf;
+  /// Start of the next line
+  size_t pos = 0;
+
+  /// Converts a numeric field, returning false if it is not a plain number
+  static bool parse_number(std::string_view field, std::vector<CsvValues> &line) {
+    const char *first = field.data();
+    const char *last = first + field.size();
+    if (field.empty() || !(std::isdigit(field[0]) || field[0] == '-'))
+      return false;
+    int64_t i;
+    auto [ptr, ec] = std::from_chars(first, last, i);
+    if (ec == std::errc() && ptr == last) {
+      line.push_back(CsvValues::Int(i));
+      return true;
+    }
+    double d;
+    auto [ptr2, ec2] = std::from_chars(first, last, d);
+    if (ec2 == std::errc() && ptr2 == last) {
+      line.push_back(CsvValues::Flt(d));
+      return true;
+    }
+    return false;
+  }
+
+  /// Splits a line of plain numbers, returning false if it is anything else
+  static bool split(std::string_view text, std::vector<CsvValues> &line) {
+    while (true) {
+      size_t comma = text.find(',');
+      if (!parse_number(text.substr(0, comma), line))
+        return false;
+      if (comma == std::string_view::npos)
+        return true;
+      text.remove_prefix(comma + 1);
+    }
+  }
+
+public:
+  /// Parses a line with the csv grammar (empty if it does not match)
+  static void parse_fallback(std::string_view text,
+                             std::vector<CsvValues> &line) {
+    constexpr auto parser = parse_line().to_fn();
+    parsum::StringInput input(text);
+    auto res = parser(input);
+    if (res.has_val)
+      line = res.ok.get_data();
+  }
+
+  /// Constructor (the buffer must outlive the tokenizer)
+  explicit CsvTokenizer(std::string_view buf) : buf(buf) {
+    if (this->buf.starts_with("\xEF\xBB\xBF"))
+      this->pos = 3; // BOM
+  }
+
+  /*
+   * @brief Reads the next non-empty line
+   * @param line Replaced by the values in the line
+   * @return False if there are no lines left
+   * @note O(n), where n is the length of the line
+   */
+  bool next(std::vector<CsvValues> &line) {
+    std::string_view text;
+    if (!next_line(text))
+      return false;
+    line.clear();
+    if (!split(text, line)) {
+      line.clear();
+      parse_fallback(text, line);
+    }
+    return true;
+  }
+
+  /*
+   * @brief Reads the text of the next non-empty line, without its line break
+   * @return False if there are no lines left
+   * @note O(n), where n is the length of the line
+   */
+  bool next_line(std::string_view &text) {
+    while (pos < buf.size()) {
+      size_t end = buf.find('\n', pos);
+      if (end == std::string_view::npos)
+        end = buf.size();
+      text = buf.substr(pos, end - pos);
+      pos = end + 1;
+      while (!text.empty() && text.back() == '\r')
+        text.remove_suffix(1);
+      if (!text.empty())
+        return true;
+    }
+    return false;
+  }
+
+  /// Number of bytes consumed so far
+  [[nodiscard]] size_t offset() const { return std::min(pos, buf.size()); }
+
+  /*
+   * @brief Reads a stream one block at a time, handing every non-empty line
+   * to fn(text, offset), where offset is the number of bytes consumed so far
+   * @details The last (partial) line of each block is carried over to the
+   * next one, so only a block and a line are in memory at once.
+   * @note O(n), where n is the length of the stream
+   */
+  template <typename F>
+  static void for_each_line(std::istream &in, size_t block_size, F fn) {
+    std::string block;
+    uint64_t done = 0;
+    while (in) {
+      size_t kept = block.size();
+      block.resize(kept + block_size);
+      in.read(block.data() + kept, (std::streamsize) block_size);
+      block.resize(kept + in.gcount());
+      // Without a line break in the block, the line goes on in the next one
+      size_t end = in ? block.rfind('\n') + 1 : block.size();
+
+      CsvTokenizer tokenizer(std::string_view(block).substr(0, end));
+      if (done > 0)
+        tokenizer.pos = 0; // only the start of the stream has a BOM
+      std::string_view text;
+      while (tokenizer.next_line(text))
+        fn(text, done + tokenizer.offset());
+      done += end;
+      block.erase(0, end);
+    }
+  }
+};
+
+/*
+ * @brief Reads csv lines with a fixed schema straight into typed columns.
+ * @details Columns are the types of the leading fields of every line (integers
+ * or floating point numbers); further fields are ignored. Each field is
+ * converted with std::from_chars and appended to a std::vector of its own, so
+ * no CsvValues or per-line vector is built. Lines that are not plain numbers
+ * go through the parse_line() grammar, as in CsvTokenizer.
+ */
+template <typename... Columns> class CsvReader {
+  static_assert(sizeof...(Columns) > 0, "A csv schema needs a column");
+  static_assert((std::is_arithmetic_v<Columns> && ...),
+                "The columns of a csv schema must be numbers");
+
+public:
+  /// Number of columns of the schema
+  static constexpr size_t NUM_COLUMNS = sizeof...(Columns);
+  /// Values of a single line
+  typedef std::tuple<Columns...> row_type;
+  /// Typical length of a line, in bytes (e.g. "0,704,120650.8\n")
+  static constexpr size_t LINE_ESTIMATE = 16;
+
+  /// Result of reading a line
+  enum Status {
+    End,      /// There are no lines left
+    Row,      /// The line was appended to the columns
+    Mismatch, /// The line does not match the schema (e.g. a header)
+  };
+
+  /// Constructor (the buffer must outlive the reader)
+  explicit CsvReader(std::string_view buf = {}) : tokenizer(buf) {
+    // Estimated from the size, so the buffer is only read once; the columns
+    // still grow if the lines are shorter
+    size_t lines = buf.size() / LINE_ESTIMATE + 1;
+    std::apply([lines](auto &...column) { (column.reserve(lines), ...); },
+               columns);
+  }
+
+  /*
+   * @brief Reads the next non-empty line into the columns
+   * @note O(n), where n is the length of the line
+   */
+  Status next() {
+    std::string_view text;
+    if (!tokenizer.next_line(text))
+      return End;
+    row_type row;
+    if (!parse_row(text, row))
+      return Mismatch;
+    append(row, std::index_sequence_for<Columns...>());
+    return Row;
+  }
+
+  /*
+   * @brief Converts the text of a line, without storing it
+   * @return False if the line does not match the schema
+   * @note O(n), where n is the length of the line
+   */
+  static bool parse_row(std::string_view text, row_type &row) {
+    return split(text, row, std::index_sequence_for<Columns...>()) ||
+           fallback(text, row, std::index_sequence_for<Columns...>());
+  }
+
+  /// Values of the I-th column of every row read so far
+  template <size_t I> const auto &column() const {
+    static_assert(I < NUM_COLUMNS, "The csv schema has no such column");
+    return std::get<I>(columns);
+  }
+
+  /// Number of rows read so far
+  [[nodiscard]] size_t size() const { return std::get<0>(columns).size(); }
+
+  /// Number of bytes consumed so far
+  [[nodiscard]] size_t offset() const { return tokenizer.offset(); }
+
+private:
+  CsvTokenizer tokenizer;
+  std::tuple<std::vector<Columns>...> columns;
+
+  /// Converts a whole field into a column type
+  template <typename T> static bool convert(std::string_view field, T &val) {
+    auto [ptr, ec] =
+        std::from_chars(field.data(), field.data() + field.size(), val);
+    return ec == std::errc() && ptr == field.data() + field.size();
+  }
+
+  /// Splits the leading fields of a line of plain numbers
+  template <size_t... I>
+  static bool split(std::string_view text, row_type &row,
+                    std::index_sequence<I...>) {
+    bool ok = true;
+    bool more = true; // whether there are fields left
+    auto field = [&](auto &val) {
+      ok = ok && more;
+      if (!ok)
+        return;
+      size_t comma = text.find(',');
+      more = comma != std::string_view::npos;
+      ok = convert(text.substr(0, comma), val);
+      if (more)
+        text.remove_prefix(comma + 1);
+    };
+    (field(std::get<I>(row)), ...);
+    return ok;
+  }
+
+  /// Reads the leading fields of a line with the csv grammar
+  template <size_t... I>
+  static bool fallback(std::string_view text, row_type &row,
+                       std::index_sequence<I...>) {
+    std::vector<CsvValues> line;
+    CsvTokenizer::parse_fallback(text, line);
+    if (line.size() < NUM_COLUMNS)
+      return false;
+    auto field = [](CsvValues const &value, auto &val) {
+      using T = std::remove_reference_t<decltype(val)>;
+      if constexpr (std::is_floating_point_v<T>) {
+        auto flt = value.get_flt();
+        val = flt.value_or(0);
+        return flt.has_value();
+      } else {
+        auto i = value.get_int();
+        val = (T) i.value_or(0);
+        return i.has_value();
+      }
+    };
+    return (field(line[I], std::get<I>(row)) && ...);
+  }
+
+  /// Appends a row to the columns
+  template <size_t... I>
+  void append(row_type const &row, std::index_sequence<I...>) {
+    (std::get<I>(columns).push_back(std::get<I>(row)), ...);
+  }
+};
+
 #endif // CSV_H
@@ -3,6 +3,7 @@
 
 #include <algorithm>
 #include <cctype>
+#include <concepts>
 #include <cstdint>
 #include <cstdlib>
 #include <cstring>
@@ -10,6 +11,7 @@
 #include <iostream>
 #include <istream>
 #include <iterator>
+#include <memory>
 #include <string>
 #include <string_view>
 #include <tuple>
@@ -118,24 +120,82 @@ inline std::string into(std::tuple<char, char, std::string> const &val) {
 // ParseError
 /**
  * @brief Type that represents the Error state of a parser
+ * @details It only holds a code, the position and the labels added by
+ * context(), so building one on a failed alternative is a few stores. The
+ * message is formatted by get_why(), when the error is reported.
  */
 struct ParseError {
 public:
   /// Level of error.
-  enum class ErrorVariant {
+  enum class ErrorVariant : uint8_t {
     Recoverable,
     Irrecoverable,
   };
 
+  /// What went wrong
+  enum class Code : uint8_t {
+    EndOfFile,     /// The input ended
+    NoMatch,       /// The next char did not match
+    ExpectedEof,   /// The input did not end
+    NotEnoughLeft, /// Fewer chars left than needed
+    MapFailed,     /// The function given to map() threw
+    ContextFailed, /// The function given to context() threw
+    NoAlternative, /// None of the alternatives matched
+  };
+
+  /// Maximum number of labels kept, further ones are dropped
+  static constexpr uint8_t MAX_LABELS = 4;
+
   /// Constructor
-  constexpr ParseError(std::string const &why, ErrorVariant kind, uint64_t pos)
-      : why(why), pos(pos), kind(kind) {};
+  constexpr ParseError(Code code, ErrorVariant kind, uint64_t pos)
+      : pos(pos), code(code), kind(kind) {};
   /// Getter for the level of error
-  constexpr ErrorVariant get_kind() { return this->kind; }
-  /// Getter for message
-  constexpr std::string const &get_why() const { return this->why; }
+  constexpr ErrorVariant get_kind() const { return this->kind; }
+  /// Getter for the code
+  constexpr Code get_code() const { return this->code; }
   /// Getter for stream position
   constexpr uint64_t get_pos() const { return pos; }
+  /// Copy of the error with a different level
+  constexpr ParseError with_kind(ErrorVariant kind) const {
+    ParseError res = *this;
+    res.kind = kind;
+    return res;
+  }
+  /// Copy of the error with a label in front of its message (the label must
+  /// outlive the error, e.g. a string literal)
+  constexpr ParseError with_context(const char *label) const {
+    ParseError res = *this;
+    if (res.num_labels < MAX_LABELS)
+      res.labels[res.num_labels++] = label;
+    return res;
+  }
+  /// Formats the message, outermost label first
+  std::string get_why() const {
+    std::string res;
+    for (uint8_t i = num_labels; i > 0; --i)
+      res += std::string(labels[i - 1]) + ": ";
+    return res + describe(code);
+  }
+  /// Description of a code
+  static constexpr const char *describe(Code code) {
+    switch (code) {
+    case Code::EndOfFile:
+      return "Reached end of file!";
+    case Code::NoMatch:
+      return "Char did not match!";
+    case Code::ExpectedEof:
+      return "Expected end of file!";
+    case Code::NotEnoughLeft:
+      return "Not enough characters left!";
+    case Code::MapFailed:
+      return "Map failed";
+    case Code::ContextFailed:
+      return "Context failed";
+    case Code::NoAlternative:
+      return "No valid alternatives found!";
+    }
+    return "";
+  }
   /// Calculates the coordinates of the error, taking the original collection in
   /// full
   template <typename T>
@@ -160,27 +220,204 @@ public:
     return {col + 1, line + 1};
   }
   /// Returns a formatted string with the error information
-  template <typename T>
-  constexpr std::string display(T const &collection) const {
+  template <typename T> std::string display(T const &collection) const {
     auto [column, line] = get_coord(collection);
     return "Found error at line " + std::to_string(line) + ", column " +
-           std::to_string(column) + ": " + std::string(this->why);
-  }
-  /// Assign operator
-  constexpr ParseError &operator=(ParseError const &other) {
-    this->why = other.why;
-    this->pos = other.pos;
-    this->kind = other.kind;
-    return *this;
+           std::to_string(column) + ": " + get_why();
   }
 
 private:
-  std::string why;
   uint64_t pos;
+  const char *labels[MAX_LABELS] = {};
+  Code code;
   ErrorVariant kind;
+  uint8_t num_labels = 0;
 };
+
+static_assert(std::is_trivially_copyable_v<ParseError>);
 // ParseError end
 
+// Input
+/**
+ * @brief Requirements of the input a parser runs on
+ * @details A parser only looks at the next char, consumes it, and saves and
+ * restores its position to backtrack. Restoring a position saved earlier on
+ * the same input must leave it as it was when the position was saved.
+ */
+template <typename I>
+concept Input = requires(I &inp, typename I::position pos, uint32_t cnt) {
+  { inp.good() } -> std::convertible_to<bool>;
+  { inp.peek() } -> std::convertible_to<char>;
+  inp.advance();
+  { inp.save() } -> std::same_as<typename I::position>;
+  inp.restore(pos);
+  { inp.offset() } -> std::convertible_to<uint64_t>;
+  std::string(inp.read(cnt));
+};
+
+/**
+ * @brief Input backed by a std::istream
+ * @details Positions are saved and restored with tellg/seekg.
+ */
+class StreamInput {
+public:
+  typedef std::istream::pos_type position;
+
+  /// Constructor (the stream must outlive the input)
+  explicit StreamInput(std::istream &inp) : inp(inp) {};
+  /// Whether there is anything left to read (false at the end of the stream,
+  /// not only after a read past it failed)
+  bool good() { return inp.peek() != std::istream::traits_type::eof(); }
+  /// Next char, without consuming it
+  char peek() { return (char) inp.peek(); }
+  /// Consumes the next char
+  void advance() { inp.ignore(); }
+  /// Current position
+  position save() { return inp.tellg(); }
+  /// Goes back to a saved position
+  void restore(position pos) {
+    inp.clear();
+    inp.seekg(pos);
+  }
+  /// Offset of the current position from the start of the stream
+  uint64_t offset() { return (uint64_t) (std::streamoff) inp.tellg(); }
+  /// Consumes up to cnt chars
+  std::string read(uint32_t cnt) {
+    std::string buf(cnt, '\0');
+    inp.read(buf.data(), cnt);
+    buf.resize(inp.gcount());
+    return buf;
+  }
+
+private:
+  std::istream &inp;
+};
+
+/**
+ * @brief Input backed by a contiguous buffer
+ * @details A position is a pointer into the buffer, so saving and restoring
+ * it is a pointer copy, and reading never copies the buffer.
+ */
+class StringInput {
+public:
+  typedef const char *position;
+
+  /// Constructor (the buffer must outlive the input)
+  explicit StringInput(std::string_view text)
+      : first(text.data()), cur(text.data()), last(text.data() + text.size()) {};
+  /// Whether there is anything left to read
+  constexpr bool good() const { return cur != last; }
+  /// Next char, without consuming it (the input must be good)
+  constexpr char peek() const { return *cur; }
+  /// Consumes the next char
+  constexpr void advance() { ++cur; }
+  /// Current position
+  constexpr position save() const { return cur; }
+  /// Goes back to a saved position
+  constexpr void restore(position pos) { cur = pos; }
+  /// Offset of the current position from the start of the buffer
+  constexpr uint64_t offset() const { return cur - first; }
+  /// Consumes up to cnt chars
+  constexpr std::string_view read(uint32_t cnt) {
+    std::string_view res(cur, std::min<size_t>(cnt, last - cur));
+    cur += res.size();
+    return res;
+  }
+  /// What is left to read
+  constexpr std::string_view rest() const { return {cur, last}; }
+  /// What was read since a saved position
+  constexpr std::string_view slice(position pos) const { return {pos, cur}; }
+
+private:
+  const char *first;
+  const char *cur;
+  const char *last;
+};
+
+/**
+ * @brief Input whose text stays in memory, so parsers can return views into it
+ * instead of copies
+ */
+template <typename I>
+concept ContiguousInput = Input<I> && requires(I &inp, typename I::position pos) {
+  { inp.slice(pos) } -> std::same_as<std::string_view>;
+};
+
+static_assert(Input<StreamInput>);
+static_assert(ContiguousInput<StringInput>);
+// Input end
+
+// FirstSet
+/**
+ * @brief Set of the chars that can come next in an input, plus its end
+ */
+struct CharSet {
+  /// Index of the end of the input
+  static constexpr unsigned END = 256;
+
+  uint64_t bits[5] = {};
+
+  /// Set with every char and the end
+  static constexpr CharSet all() {
+    CharSet res;
+    for (unsigned i = 0; i <= END; ++i)
+      res.set(i);
+    return res;
+  }
+  /// Set with the chars matching a predicate
+  template <typename Fn> static constexpr CharSet of(Fn const &fn) {
+    CharSet res;
+    for (unsigned i = 0; i < END; ++i)
+      if (fn((char) i))
+        res.set(i);
+    return res;
+  }
+  /// Adds a char, or END
+  constexpr void set(unsigned i) { bits[i / 64] |= uint64_t(1) << (i % 64); }
+  /// Whether it has a char, or END
+  constexpr bool test(unsigned i) const {
+    return (bits[i / 64] >> (i % 64)) & 1;
+  }
+  /// Union
+  constexpr CharSet operator|(CharSet const &other) const {
+    CharSet res;
+    for (unsigned i = 0; i < 5; ++i)
+      res.bits[i] = bits[i] | other.bits[i];
+    return res;
+  }
+  /// Intersection
+  constexpr CharSet operator&(CharSet const &other) const {
+    CharSet res;
+    for (unsigned i = 0; i < 5; ++i)
+      res.bits[i] = bits[i] & other.bits[i];
+    return res;
+  }
+};
+
+/**
+ * @brief What a parser can do depending on the next char of its input
+ * @details A parser whose next char is not in viable() can only fail
+ * recoverably there, so an alternative may skip it. The sets are computed
+ * when the parser is built, which the wrappers do at compile time.
+ */
+struct FirstSet {
+  /// Next chars where it may consume input, or fail irrecoverably
+  CharSet consume;
+  /// Next chars where it may succeed without consuming input
+  CharSet empty;
+
+  /// Next chars where it may not fail recoverably
+  constexpr CharSet viable() const { return consume | empty; }
+  /// First set of a parser that may do anything
+  static constexpr FirstSet any() { return {CharSet::all(), CharSet::all()}; }
+};
+
+/// Index in a CharSet of the next char of an input
+constexpr unsigned next_char(Input auto &inp) {
+  return inp.good() ? (unsigned) (unsigned char) inp.peek() : CharSet::END;
+}
+// FirstSet end
+
 /**
  * @brief Type that represents the result of an operations: either succsess or
  * error.
@@ -193,34 +430,63 @@ template <typename T, typename E> struct Result {
     E err;
   };
   constexpr Result(T const &val) : has_val(true), ok(val) {};
+  constexpr Result(T &&val) : has_val(true), ok(std::move(val)) {};
   constexpr Result(E const &err) : has_val(false), err(err) {};
-  constexpr Result(Result<T, E> const &other) {
-    this->has_val = other.has_val;
+  constexpr Result(E &&err) : has_val(false), err(std::move(err)) {};
+  constexpr Result(Result<T, E> const &other) : has_val(other.has_val) {
     if (other.has_val)
-      this->ok = other.ok;
+      std::construct_at(&this->ok, other.ok);
     else
-      this->err = other.err;
+      std::construct_at(&this->err, other.err);
   }
-  constexpr Result<T, E> &operator=(Result<T, E> const &other) {
-    this->has_val = other.has_val;
+  constexpr Result(Result<T, E> &&other) noexcept(
+      std::is_nothrow_move_constructible_v<T> &&
+      std::is_nothrow_move_constructible_v<E>)
+      : has_val(other.has_val) {
     if (other.has_val)
-      this->ok = other.ok;
+      std::construct_at(&this->ok, std::move(other.ok));
     else
-      this->err = other.err;
+      std::construct_at(&this->err, std::move(other.err));
+  }
+  constexpr Result<T, E> &operator=(Result<T, E> const &other) {
+    if (this != &other) {
+      destroy();
+      this->has_val = other.has_val;
+      if (other.has_val)
+        std::construct_at(&this->ok, other.ok);
+      else
+        std::construct_at(&this->err, other.err);
+    }
     return *this;
   }
-  ~Result() {
-    if (has_val) {
-      ok.~T();
-    } else
-      err.~E();
+  constexpr Result<T, E> &operator=(Result<T, E> &&other) noexcept(
+      std::is_nothrow_move_constructible_v<T> &&
+      std::is_nothrow_move_constructible_v<E>) {
+    if (this != &other) {
+      destroy();
+      this->has_val = other.has_val;
+      if (other.has_val)
+        std::construct_at(&this->ok, std::move(other.ok));
+      else
+        std::construct_at(&this->err, std::move(other.err));
+    }
+    return *this;
   }
+  ~Result() { destroy(); }
   template <typename Tgt> operator Result<Tgt, E>() const {
     if (this->has_val) {
       return into<T, Tgt>(this->ok);
     } else
       return this->err;
   }
+
+private:
+  constexpr void destroy() {
+    if (has_val)
+      std::destroy_at(&this->ok);
+    else
+      std::destroy_at(&this->err);
+  }
 };
 
 template <typename P, typename F>
@@ -236,6 +502,9 @@ template <typename Derived, typename Out> struct Parser {
   constexpr auto to_fn() const {
     return static_cast<Derived const &>(*this).to_fn_impl();
   }
+  constexpr FirstSet first() const {
+    return static_cast<Derived const &>(*this).first_impl();
+  }
   template <typename Out2> operator Parser<Derived, Out2>() const {
     return map(*this, [](Out const &val) { return convert(val); });
   }
@@ -249,20 +518,21 @@ template <typename Fn> struct VerifyP : public Parser<VerifyP<Fn>, char> {
   Fn fn;
   using Parser<VerifyP<Fn>, char>::Parser;
   constexpr VerifyP(Fn const &fn) : fn(fn) {};
+  constexpr FirstSet first_impl() const { return {CharSet::of(fn), {}}; }
   constexpr auto to_fn_impl() const {
     auto fn_ = this->fn;
-    return [fn_](std::istream &inp) -> Result<char, ParseError> {
-      if (!inp) {
-        return ParseError("Reached end of file!",
-                          ParseError::ErrorVariant::Recoverable, inp.tellg());
+    return [fn_](Input auto &inp) -> Result<char, ParseError> {
+      if (!inp.good()) {
+        return ParseError(ParseError::Code::EndOfFile,
+                          ParseError::ErrorVariant::Recoverable, inp.offset());
       }
       const char val = inp.peek();
       if (fn_(val)) {
-        inp.ignore();
+        inp.advance();
         return val;
       } else {
-        return ParseError("Char did not match!",
-                          ParseError::ErrorVariant::Recoverable, inp.tellg());
+        return ParseError(ParseError::Code::NoMatch,
+                          ParseError::ErrorVariant::Recoverable, inp.offset());
       }
     };
   }
@@ -280,19 +550,25 @@ struct Sequence : public Parser<Sequence<P1, P2>, Out> {
   using Parser<Sequence<P1, P2>, Out>::Parser;
   constexpr Sequence(P1 const &p1, P2 const &p2) : p1(p1), p2(p2) {};
 
+  constexpr FirstSet first_impl() const {
+    FirstSet f1 = p1.first();
+    FirstSet f2 = p2.first();
+    return {f1.consume | (f1.empty & f2.viable()), f1.empty & f2.empty};
+  }
+
   constexpr auto to_fn_impl() const {
     auto p1_impl = p1.to_fn();
     auto p2_impl = p2.to_fn();
-    return [p1_impl, p2_impl](std::istream &inp) -> Result<Out, ParseError> {
-      auto pos = inp.tellg();
+    return [p1_impl, p2_impl](Input auto &inp) -> Result<Out, ParseError> {
+      auto pos = inp.save();
       auto res1 = p1_impl(inp);
       if (!res1.has_val) {
-        inp.seekg(pos);
+        inp.restore(pos);
         return res1.err;
       }
       auto res2 = p2_impl(inp);
       if (!res2.has_val) {
-        inp.seekg(pos);
+        inp.restore(pos);
         return res2.err;
       }
       return join_tup(res1.ok, res2.ok);
@@ -302,6 +578,10 @@ struct Sequence : public Parser<Sequence<P1, P2>, Out> {
 
 /**
  * @brief Type that represents applying either one parser or another
+ * @details The first sets of both parsers are computed when it is built. The
+ * first parser is only tried if the next char is viable for it; otherwise the
+ * input goes straight to the second one. Chains of alternatives nest to the
+ * left, so a single lookup skips every branch before the viable one.
  */
 template <typename P1, typename P2, typename Out = typename P2::value_type>
 struct Alternative : public Parser<Alternative<P1, P2>, Out> {
@@ -309,27 +589,43 @@ struct Alternative : public Parser<Alternative<P1, P2>, Out> {
 
   P1 p1;
   P2 p2;
-  constexpr Alternative(P1 const &p1, P2 const &p2) : p1(p1), p2(p2) {};
+  FirstSet first1;
+  FirstSet first2;
+  constexpr Alternative(P1 const &p1, P2 const &p2)
+      : p1(p1), p2(p2), first1(p1.first()), first2(p2.first()) {};
+
+  constexpr FirstSet first_impl() const {
+    return {first1.consume | first2.consume, first1.empty | first2.empty};
+  }
 
   constexpr auto to_fn_impl() const {
     auto p1_impl = p1.to_fn();
     auto p2_impl = p2.to_fn();
-
-    return [p1_impl, p2_impl](std::istream &inp) -> Result<Out, ParseError> {
-      auto pos = inp.tellg();
+    CharSet viable1 = first1.viable();
+
+    return [p1_impl, p2_impl,
+            viable1](Input auto &inp) -> Result<Out, ParseError> {
+      auto pos = inp.save();
+      if (!viable1.test(next_char(inp))) {
+        auto res2 = p2_impl(inp);
+        if (res2.has_val)
+          return std::move(res2.ok);
+        inp.restore(pos);
+        return res2.err;
+      }
       auto res1 = p1_impl(inp);
       if (res1.has_val)
-        return res1.ok;
+        return std::move(res1.ok);
       else if (res1.err.get_kind() == ParseError::ErrorVariant::Irrecoverable) {
-        inp.seekg(pos);
+        inp.restore(pos);
         return res1.err;
       }
-      inp.seekg(pos);
+      inp.restore(pos);
       auto res2 = p2_impl(inp);
       if (res2.has_val) {
-        return res2.ok;
+        return std::move(res2.ok);
       } else {
-        inp.seekg(pos);
+        inp.restore(pos);
         return res2.err;
       }
     };
@@ -349,22 +645,24 @@ struct Map : public Parser<Map<P, F>, Out> {
   const F f;
   constexpr Map(P const &parser, F const &f) : p(parser), f(f) {};
 
+  constexpr FirstSet first_impl() const { return p.first(); }
+
   constexpr auto to_fn_impl() const {
     auto p_impl = p.to_fn();
     auto fn = f;
-    return [p_impl, fn](std::istream &inp) -> Result<Out, ParseError> {
-      auto pos = inp.tellg();
+    return [p_impl, fn](Input auto &inp) -> Result<Out, ParseError> {
+      auto pos = inp.save();
       auto res = p_impl(inp);
       if (!res.has_val) {
-        inp.seekg(pos);
+        inp.restore(pos);
         return res.err;
       }
       try {
-        return fn(res.ok);
+        return fn(std::move(res.ok));
       } catch (std::exception &) {
-        inp.seekg(pos);
-        return ParseError("Map failed", ParseError::ErrorVariant::Recoverable,
-                          pos);
+        inp.restore(pos);
+        return ParseError(ParseError::Code::MapFailed,
+                          ParseError::ErrorVariant::Recoverable, inp.offset());
       }
     };
   }
@@ -383,26 +681,62 @@ struct Context : public Parser<Context<P, F>, typename P::value_type> {
   const F f;
   constexpr Context(P const &parser, F const &f) : p(parser), f(f) {};
 
+  /// f may turn a recoverable failure irrecoverable, on any char
+  constexpr FirstSet first_impl() const {
+    return {CharSet::all(), p.first().empty};
+  }
+
   constexpr auto to_fn_impl() const {
     auto p_impl = p.to_fn();
     auto fn = f;
     return [p_impl,
-            fn](std::istream &inp) -> Result<typename P::value_type, Err> {
-      auto pos = inp.tellg();
+            fn](Input auto &inp) -> Result<typename P::value_type, Err> {
+      auto pos = inp.save();
       auto res = p_impl(inp);
       if (res.has_val)
-        return res.ok;
-      inp.seekg(pos);
+        return std::move(res.ok);
+      inp.restore(pos);
       try {
         return fn(res.err);
       } catch (std::exception &) {
-        return ParseError("Context failed",
-                          ParseError::ErrorVariant::Recoverable, inp.tellg());
+        return ParseError(ParseError::Code::ContextFailed,
+                          ParseError::ErrorVariant::Recoverable, inp.offset());
       }
     };
   }
 };
 
+/**
+ * @brief Type that represents adding a label to a failed result of a parser
+ * @details Unlike Context, the error keeps its code and level, so it fails
+ * recoverably exactly where the parser does and keeps its FirstSet.
+ */
+template <typename P>
+struct Label : public Parser<Label<P>, typename P::value_type> {
+  using Parser<Label<P>, typename P::value_type>::Parser;
+
+  const P p;
+  const char *label;
+  constexpr Label(P const &parser, const char *label)
+      : p(parser), label(label) {};
+
+  constexpr FirstSet first_impl() const { return p.first(); }
+
+  constexpr auto to_fn_impl() const {
+    auto p_impl = p.to_fn();
+    const char *text = label;
+    return [p_impl,
+            text](Input auto &inp) -> Result<typename P::value_type, ParseError> {
+      auto pos = inp.save();
+      auto res = p_impl(inp);
+      if (res.has_val)
+        return std::move(res.ok);
+      inp.restore(pos);
+      return res.err.with_context(text);
+    };
+  }
+};
+
 /**
  * @brief Type that represents parsing at least once
  */
@@ -412,30 +746,30 @@ template <typename P, typename Out> struct Many1 : Parser<Many1<P, Out>, Out> {
   const P p;
   constexpr Many1(P const &p) : p(p) {};
 
+  constexpr FirstSet first_impl() const { return p.first(); }
+
   constexpr auto to_fn_impl() const {
     auto p_impl = p.to_fn();
 
-    return [p_impl](std::istream &inp) -> Result<Out, ParseError> {
-      auto pos_1 = inp.tellg();
+    return [p_impl](Input auto &inp) -> Result<Out, ParseError> {
+      auto pos_1 = inp.save();
       auto fst = p_impl(inp);
       if (!fst.has_val) {
-        inp.seekg(pos_1);
+        inp.restore(pos_1);
         return fst.err;
       }
-      Out tgt = fst.ok;
+      Out tgt = std::move(fst.ok);
       while (true) {
-        auto pos = inp.tellg();
+        auto pos = inp.save();
         auto nxt = p_impl(inp);
         if (!nxt.has_val) {
-          inp.seekg(pos);
+          inp.restore(pos);
           if (nxt.err.get_kind() == ParseError::ErrorVariant::Irrecoverable) {
             return nxt.err;
           }
           return tgt;
         }
-        Out nxt_tgt = nxt.ok;
-
-        std::copy(std::begin(nxt_tgt), std::end(nxt_tgt),
+        std::move(std::begin(nxt.ok), std::end(nxt.ok),
                   std::back_inserter(tgt));
       }
     };
@@ -451,10 +785,12 @@ struct Const : public Parser<Const<F>, typename std::invoke_result_t<F>> {
   const F res_fn;
   constexpr Const(F const &res_fn) : res_fn(res_fn) {};
 
+  constexpr FirstSet first_impl() const { return {{}, CharSet::all()}; }
+
   constexpr auto to_fn_impl() const {
     const auto res_fn = this->res_fn;
 
-    return [res_fn](std::istream &) -> Result<Out, ParseError> {
+    return [res_fn](Input auto &) -> Result<Out, ParseError> {
       return res_fn();
     };
   }
@@ -467,15 +803,15 @@ template <typename P, typename Out = typename P::value_type>
 struct Cut : public Parser<Cut<P, Out>, Out> {
   const P p;
   constexpr Cut(P const &p) : p(p) {};
+  /// Any failure is irrecoverable, so it is viable everywhere
+  constexpr FirstSet first_impl() const { return FirstSet::any(); }
   constexpr auto to_fn_impl() const {
     auto p_impl = p.to_fn();
-    return [p_impl](std::istream &inp) -> Result<Out, ParseError> {
+    return [p_impl](Input auto &inp) -> Result<Out, ParseError> {
       auto res = p_impl(inp);
       if (res.has_val)
-        return res.ok;
-      ParseError err = res.err;
-      return ParseError(err.get_why(), ParseError::ErrorVariant::Irrecoverable,
-                        err.get_pos());
+        return std::move(res.ok);
+      return res.err.with_kind(ParseError::ErrorVariant::Irrecoverable);
     };
   }
 };
@@ -487,14 +823,17 @@ struct Cut : public Parser<Cut<P, Out>, Out> {
 template <typename P> struct Peek : public Parser<Peek<P>, std::tuple<>> {
   const P p;
   constexpr Peek(P const &p) : p(p) {};
+  constexpr FirstSet first_impl() const {
+    FirstSet f = p.first();
+    return {f.consume, f.viable()};
+  }
   constexpr auto to_fn_impl() const {
     auto p_impl = p.to_fn();
-    return [p_impl](std::istream &inp) -> Result<std::tuple<>, ParseError> {
-      auto pos = inp.tellg();
+    return [p_impl](Input auto &inp) -> Result<std::tuple<>, ParseError> {
+      auto pos = inp.save();
       auto res = p_impl(inp);
       if (res.has_val) {
-        inp.seekg(pos);
-        inp.clear();
+        inp.restore(pos);
         return std::tuple<>{};
       }
       return res.err;
@@ -502,34 +841,136 @@ template <typename P> struct Peek : public Parser<Peek<P>, std::tuple<>> {
   }
 };
 
+/**
+ * @brief Type that succeeds only at the end of the input, without consuming
+ * anything
+ */
+struct Eof : public Parser<Eof, std::tuple<>> {
+  constexpr FirstSet first_impl() const {
+    CharSet end;
+    end.set(CharSet::END);
+    return {{}, end};
+  }
+  constexpr auto to_fn_impl() const {
+    return [](Input auto &inp) -> Result<std::tuple<>, ParseError> {
+      if (inp.good())
+        return ParseError(ParseError::Code::ExpectedEof,
+                          ParseError::ErrorVariant::Recoverable, inp.offset());
+      return std::tuple<>{};
+    };
+  }
+};
+
 /**
  * @brief Type that represents indescriminately taking n chars from an input
  */
 struct Take : public Parser<Take, std::string> {
   const uint32_t cnt;
   constexpr Take(uint32_t const &cnt) : cnt(cnt) {};
+  constexpr FirstSet first_impl() const {
+    if (cnt == 0)
+      return {{}, CharSet::all()};
+    return {CharSet::of([](char) { return true; }), {}};
+  }
   constexpr auto to_fn_impl() const {
     auto cnt = this->cnt;
-    return [cnt](std::istream &inp) -> Result<std::string, ParseError> {
-      auto pos = inp.tellg();
-      char *buf = new char[cnt + 1];
-      memset(buf, 0, cnt + 1);
-      inp.read(buf, cnt);
-      if (cnt != inp.gcount()) {
-        inp.clear();
-        inp.seekg(pos);
-        inp.clear();
-        return ParseError("Could not take " + std::to_string(cnt) +
-                              " characters!",
-                          ParseError::ErrorVariant::Recoverable, pos);
+    return [cnt](Input auto &inp) -> Result<std::string, ParseError> {
+      auto pos = inp.save();
+      auto res = std::string(inp.read(cnt));
+      if (cnt != res.size()) {
+        inp.restore(pos);
+        return ParseError(ParseError::Code::NotEnoughLeft,
+                          ParseError::ErrorVariant::Recoverable, inp.offset());
       }
-      auto res = std::string(buf);
-      delete[] buf;
       return res;
     };
   }
 };
 
+/**
+ * @brief Type that represents consuming the longest run of chars matching a
+ * predicate, returning a view of them
+ * @details Nothing is copied or allocated, so it only runs on a
+ * ContiguousInput, and the view is valid as long as the input buffer.
+ */
+template <typename Fn>
+struct TakeWhile : public Parser<TakeWhile<Fn>, std::string_view> {
+  Fn fn;
+  const uint32_t min;
+  constexpr TakeWhile(Fn const &fn, uint32_t min) : fn(fn), min(min) {};
+  constexpr FirstSet first_impl() const {
+    return {CharSet::of(fn), min == 0 ? CharSet::all() : CharSet()};
+  }
+  constexpr auto to_fn_impl() const {
+    auto fn_ = this->fn;
+    auto min = this->min;
+    return [fn_, min](ContiguousInput auto &inp)
+               -> Result<std::string_view, ParseError> {
+      auto pos = inp.save();
+      while (inp.good() && fn_(inp.peek()))
+        inp.advance();
+      std::string_view res = inp.slice(pos);
+      if (res.size() < min) {
+        inp.restore(pos);
+        return ParseError(ParseError::Code::NoMatch,
+                          ParseError::ErrorVariant::Recoverable, inp.offset());
+      }
+      return res;
+    };
+  }
+};
+
+/**
+ * @brief Type that represents running a parser and returning a view of the
+ * text it consumed, instead of its result
+ */
+template <typename P>
+struct Recognize : public Parser<Recognize<P>, std::string_view> {
+  const P p;
+  constexpr Recognize(P const &p) : p(p) {};
+  constexpr FirstSet first_impl() const { return p.first(); }
+  constexpr auto to_fn_impl() const {
+    auto p_impl = p.to_fn();
+    return [p_impl](ContiguousInput auto &inp)
+               -> Result<std::string_view, ParseError> {
+      auto pos = inp.save();
+      auto res = p_impl(inp);
+      if (!res.has_val) {
+        inp.restore(pos);
+        return res.err;
+      }
+      return inp.slice(pos);
+    };
+  }
+};
+
+/**
+ * @brief Type that represents matching a fixed string, returning it
+ */
+struct Tag : public Parser<Tag, std::string_view> {
+  const std::string_view tag;
+  constexpr Tag(std::string_view tag) : tag(tag) {};
+  constexpr FirstSet first_impl() const {
+    if (tag.empty())
+      return {{}, CharSet::all()};
+    CharSet fst;
+    fst.set((unsigned char) tag[0]);
+    return {fst, {}};
+  }
+  constexpr auto to_fn_impl() const {
+    auto tag = this->tag;
+    return [tag](Input auto &inp) -> Result<std::string_view, ParseError> {
+      auto pos = inp.save();
+      if (inp.read(tag.size()) != tag) {
+        inp.restore(pos);
+        return ParseError(ParseError::Code::NoMatch,
+                          ParseError::ErrorVariant::Recoverable, inp.offset());
+      }
+      return tag;
+    };
+  }
+};
+
 /**
  * @brief Wrapper over Const
  */
@@ -570,6 +1011,15 @@ consteval auto context(P const &p, F const &f) {
   return Context(p, f);
 }
 
+/**
+ * @brief Wrapper over Label (the label must outlive the parser, e.g. a string
+ * literal)
+ */
+template <typename P>
+consteval auto label(P const &p, const char *text) {
+  return Label(p, text);
+}
+
 /**
  * @brief Wrapper over VerifyP
  */
@@ -641,24 +1091,42 @@ template <typename P> consteval auto cut(P const &p) { return Cut<P>(p); }
  */
 template <typename P> consteval auto peek(P const &p) { return Peek<P>(p); }
 
+/**
+ * @brief Wrapper over Eof
+ */
+consteval auto eof() { return Eof(); }
+
 /**
  * @brief Wrapper over Take
  */
 consteval auto take(uint32_t const &cnt) { return Take(cnt); }
 
 /**
- * @brief Matches and parses string
+ * @brief Wrapper over TakeWhile, matching zero or more chars
  */
-consteval auto string_p(std::string_view const &inp) {
-  return map(take(inp.size()), [inp](auto s) {
-    if (s == inp) {
-      return s;
-    } else {
-      throw std::exception();
-    }
-  });
+template <typename F> consteval auto take_while0(F const &fun) {
+  return TakeWhile(fun, 0);
+}
+
+/**
+ * @brief Wrapper over TakeWhile, matching one or more chars
+ */
+template <typename F> consteval auto take_while1(F const &fun) {
+  return TakeWhile(fun, 1);
+}
+
+/**
+ * @brief Wrapper over Recognize
+ */
+template <typename P> consteval auto recognize(P const &p) {
+  return Recognize<P>(p);
 }
 
+/**
+ * @brief Matches and parses string
+ */
+consteval auto string_p(std::string_view const &inp) { return Tag(inp); }
+
 /**
  * @brief Function that wraps a method to transform a parser into a function
  */
@@ -669,29 +1137,34 @@ template <typename Pars> consteval auto parse_fn(Pars const &parser) {
 /**
  * @brief Function that checks if a char is a digit
  */
-constexpr bool is_digit(char const &c) { return std::isdigit(c); }
+constexpr bool is_digit(char const &c) { return '0' <= c && c <= '9'; }
 
 /**
  * @brief Function that checks if a char is alphabetic
  */
-constexpr bool is_alpha(char const &c) { return std::isalpha(c); }
+constexpr bool is_alpha(char const &c) {
+  return ('a' <= c && c <= 'z') || ('A' <= c && c <= 'Z');
+}
 
 /**
  * @brief Function that checks if a char is alphanumeric
  */
-constexpr bool is_alphanumeric(char const &c) { return std::isalnum(c); }
+constexpr bool is_alphanumeric(char const &c) {
+  return is_alpha(c) || is_digit(c);
+}
 
 /**
  * @brief Function that checks if a char is whitespace
  */
-constexpr bool is_whitespace(char const &c) { return std::isspace(c); }
+constexpr bool is_whitespace(char const &c) {
+  return c == ' ' || ('\t' <= c && c <= '\r');
+}
 
 /**
  * @brief Function that checks if a char is a hexadecimal digit
  */
 constexpr bool is_hex_digit(char const &c) {
-  return ('0' <= c && '9' >= 'c') || ('A' <= c && 'F' >= c) ||
-         ('a' <= c && 'f' >= c);
+  return is_digit(c) || ('A' <= c && 'F' >= c) || ('a' <= c && 'f' >= c);
 }
 
 /**
@@ -702,14 +1175,14 @@ consteval auto digit() {
 }
 
 /**
- * @brief Parses one or more digits
+ * @brief Parses one or more digits, as a view
  */
-consteval auto digits1() { return many1(digit()); }
+consteval auto digits1() { return take_while1(&is_digit); }
 
 /**
- * @brief Parses zero or more digits
+ * @brief Parses zero or more digits, as a view
  */
-consteval auto digits0() { return many0(digit()); }
+consteval auto digits0() { return take_while0(&is_digit); }
 
 /**
  * @brief Parses a single alphabetic
@@ -719,14 +1192,14 @@ consteval auto alphabetic() {
 }
 
 /**
- * @brief Parses a one or more alphabetics
+ * @brief Parses a one or more alphabetics, as a view
  */
-consteval auto alphabetics1() { return many1(alphabetic()); }
+consteval auto alphabetics1() { return take_while1(&is_alpha); }
 
 /**
- * @brief Parses a zero or more alphabetics
+ * @brief Parses a zero or more alphabetics, as a view
  */
-consteval auto alphabetics0() { return many0(alphabetic()); }
+consteval auto alphabetics0() { return take_while0(&is_alpha); }
 
 /**
  * @brief Parses a single alphanumeric
@@ -737,14 +1210,14 @@ consteval auto alphanumeric() {
 }
 
 /**
- * @brief Parses a one or more alphanumerics
+ * @brief Parses a one or more alphanumerics, as a view
  */
-consteval auto alphanumerics1() { return many1(alphanumeric()); }
+consteval auto alphanumerics1() { return take_while1(&is_alphanumeric); }
 
 /**
- * @brief Parses a zero or more alphanumerics
+ * @brief Parses a zero or more alphanumerics, as a view
  */
-consteval auto alphanumerics0() { return many0(alphanumeric()); }
+consteval auto alphanumerics0() { return take_while0(&is_alphanumeric); }
 
 /**
  * @brief Parses a single hex digit
@@ -755,30 +1228,24 @@ consteval auto hex_digit() {
 }
 
 /**
- * @brief Parses a one or more hex digits
+ * @brief Parses a one or more hex digits, as a view
  */
-consteval auto hex_digits1() { return many1(hex_digit()); }
+consteval auto hex_digits1() { return take_while1(&is_hex_digit); }
 
 /**
- * @brief Parses a zero or more hex digits
+ * @brief Parses a zero or more hex digits, as a view
  */
-consteval auto hex_digits0() { return many0(hex_digit()); }
+consteval auto hex_digits0() { return take_while0(&is_hex_digit); }
 
 /**
- * @brief Parses a zero or more whitespace
+ * @brief Parses a zero or more whitespace, as a view
  */
-consteval auto ws0() {
-  return many0(
-      map(verify(&is_whitespace), [](auto c) { return std::string{c}; }));
-}
+consteval auto ws0() { return take_while0(&is_whitespace); }
 
 /**
- * @brief Parses a one or more whitespace
+ * @brief Parses a one or more whitespace, as a view
  */
-consteval auto ws1() {
-  return many1(
-      map(verify(&is_whitespace), [](auto c) { return std::string{c}; }));
-}
+consteval auto ws1() { return take_while1(&is_whitespace); }
 
 } // namespace parsum
 #endif
@@ -1,5 +1,6 @@
 #include "Runtime.h"
 #include "Utils.h"
+#include <charconv>
 #include <iostream>
 #include <istream>
 #include <ostream>
@@ -21,8 +22,7 @@ Runtime::Runtime(Data *d) { this->data = d; }
     std::getline(std::cin, input);
     if (input.empty())
       continue;
-    std::istringstream iss(input);
-    processArgs(iss);
+    processArgs(input);
   }
 }
 
@@ -40,6 +40,13 @@ void Runtime::printHelp() {
             << comment << "      Resolves the TSP problem using backtracking.\n"
             << comment
             << "      This command also works for disconnected graphs.\n"
+            << keyword << "  held-karp [<memory-MB>]\n"
+            << comment
+            << "      Resolves the TSP problem using the Held-Karp dynamic "
+               "programming algorithm.\n"
+            << comment
+            << "      Refuses graphs that would need more than <memory-MB> "
+               "(by default, " << HELD_KARP_MEMORY << ") MB.\n"
             << keyword << "  triangular\n"
             << comment
             << "      Generates an approximation of the TSP problem using the "
@@ -61,6 +68,10 @@ void Runtime::printHelp() {
             << comment
             << "      This command will not assume any edge not given by the "
                ".csv files.\n"
+            << keyword << "  cache\n"
+            << comment
+            << "      Prints the hits and misses of the cache of distances "
+               "between vertices without an edge.\n"
             << Color::clear() << std::endl;
 }
 
@@ -70,17 +81,56 @@ void Runtime::handleQuit() {
 }
 
 void Runtime::handleCount() {
-  auto &g = data->getGraph();
-  unsigned int edgeCount = 0;
-  for (auto v : g.getVertexSet()) {
-    edgeCount += v.second.getAdj().size();
-  }
-  std::cout << "Number of vertices: " << g.getVertexSet().size() << std::endl;
-  std::cout << "Number of edges: " << edgeCount << std::endl;
+  const CSRGraph &g = data->getCSR();
+  std::cout << "Number of vertices: " << g.getNumVertex() << std::endl;
+  std::cout << "Number of edges: " << g.getNumEdges() << std::endl;
+  std::cout << "Weights stored as: " << WeightTraits<Weight>::name
+            << std::endl;
 }
 
 void Runtime::handleBacktracking() {
-  std::cout << data->backtracking() << std::endl;
+  uint64_t nodes;
+  Clock c;
+  c.start();
+  TSPResult res = data->backtracking(&nodes);
+  c.stop();
+  std::cout << res << std::endl;
+  std::cout << "Nodes explored: " << nodes;
+  if (c.getTime() > 0)
+    std::cout << " (" << (uint64_t) (nodes / c.getTime() * 1000) << "/s)";
+  std::cout << std::endl;
+}
+
+void Runtime::handleHeldKarp(Command &cmd) {
+  uint64_t budget = HELD_KARP_MEMORY;
+  if (!cmd.args.empty()) {
+    // The budget is given in MB, and must still fit in 64 bits in bytes
+    std::string digits = cmd.args.at(0).getStr().value();
+    auto [ptr, ec] =
+        std::from_chars(digits.data(), digits.data() + digits.size(), budget);
+    if (ec != std::errc() || ptr != digits.data() + digits.size() ||
+        budget == 0 || budget > UINT64_MAX >> 20) {
+      error("The memory budget must be between 1 and " +
+            std::to_string(UINT64_MAX >> 20) + " MB.");
+      return;
+    }
+  }
+  uint32_t n = data->getCSR().getNumVertex();
+  if (n > HELD_KARP_MAX_VERTICES) {
+    error("Held-Karp solves graphs of up to " +
+          std::to_string(HELD_KARP_MAX_VERTICES) + " vertices.");
+    return;
+  }
+  auto result = data->heldKarp(budget << 20);
+  if (!result.has_value()) {
+    uint64_t needed = HeldKarp::memory(n);
+    error("Held-Karp needs " +
+          (needed == UINT64_MAX ? "too much" : std::to_string((needed >> 20) + 1) + "MB of") +
+          " memory for this graph, over the budget of " +
+          std::to_string(budget) + "MB.");
+    return;
+  }
+  std::cout << result.value() << std::endl;
 }
 
 void Runtime::handleTriangular() {
@@ -92,8 +142,7 @@ void Runtime::handleHeuristic() { std::cout << data->heuristic() << std::endl; }
 void Runtime::handleDisconnected(Command &cmd) {
   unsigned vertexId = cmd.args.at(0).getInt().value();
   unsigned iterations = cmd.args.at(1).getInt().value();
-  Graph<Info> &g = data->getGraph();
-  if (!g.hasVertex(vertexId)) {
+  if (!data->getIds().find(vertexId).has_value()) {
     error("Vertex " + std::to_string(vertexId) + " does not exist.");
     return;
   }
@@ -106,20 +155,27 @@ void Runtime::handleDisconnected(Command &cmd) {
   }
 }
 
-void Runtime::processArgs(std::istream &args) {
+void Runtime::handleCache() {
+  DistanceCache::Stats stats = data->getCacheStats();
+  uint64_t lookups = stats.hits + stats.misses;
+  std::cout << "Hits: " << stats.hits << std::endl;
+  std::cout << "Misses: " << stats.misses << std::endl;
+  if (lookups > 0)
+    std::cout << "Hit rate: " << 100.0 * stats.hits / lookups << "%"
+              << std::endl;
+}
+
+void Runtime::processArgs(std::string_view input) {
   constexpr auto cmd_parser = parse_cmd();
-  auto pos = args.tellg();
+  parsum::StringInput args(input);
   auto cmd_res = cmd_parser.to_fn()(args);
   if (!cmd_res.has_val) {
-    args.clear();
-    args.seekg(pos);
-    std::string arg_contents(std::istreambuf_iterator<char>(args), {});
-    return error("The command '" + arg_contents +
+    return error("The command '" + std::string(input) +
                  "' is invalid. Type 'help' to know more.");
   }
   auto cmd = cmd_res.ok;
 
-  std::string rest(std::istreambuf_iterator<char>(args), {});
+  std::string rest(args.rest());
   if (!rest.empty())
     warning("Trailing output: '" + rest + "'.");
 
@@ -131,9 +187,14 @@ void Runtime::processArgs(std::istream &args) {
     return handleQuit();
   case Command::Count:
     return handleCount();
+  case Command::Cache:
+    return handleCache();
   case Command::Backtracking:
     handleBacktracking();
     break;
+  case Command::HeldKarp:
+    handleHeldKarp(cmd);
+    break;
   case Command::Triangular:
     handleTriangular();
     break;
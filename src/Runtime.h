@@ -6,11 +6,14 @@
 #include "data/Data.h"
 #include <array>
 #include <cctype>
+#include <charconv>
 #include <cstdint>
 #include <exception>
 #include <istream>
 #include <optional>
 #include <string>
+#include <string_view>
+#include <system_error>
 #include <tuple>
 #include <utility>
 #include <vector>
@@ -46,15 +49,19 @@ public:
   // static Parser<CommandLineValue> parse_ident();
 
   static consteval auto parse_int() {
-    return parsum::map(parsum::digits1(), [](std::string num) {
-      return CommandLineValue(Kind::Int, (uint32_t) std::stoul(num));
+    return parsum::map(parsum::digits1(), [](std::string_view num) {
+      uint32_t val;
+      auto [ptr, ec] = std::from_chars(num.data(), num.data() + num.size(), val);
+      if (ec != std::errc())
+        throw std::exception();
+      return CommandLineValue(Kind::Int, val);
     });
   }
 
   static consteval auto parse_str() {
-    return parsum::map(parsum::alphanumerics1(), [](auto s) {
-      if (s.find_first_not_of("0123456789") != std::string::npos) {
-        return CommandLineValue(Kind::String, s);
+    return parsum::map(parsum::alphanumerics1(), [](std::string_view s) {
+      if (s.find_first_not_of("0123456789") != std::string_view::npos) {
+        return CommandLineValue(Kind::String, std::string(s));
       } else {
         throw std::exception();
       }
@@ -77,9 +84,11 @@ public:
     Quit,
     Count,
     Backtracking,
+    HeldKarp,
     Triangular,
     Heuristic,
     Disconnected,
+    Cache,
   } command;
   std::vector<CommandLineValue> args;
 
@@ -102,10 +111,9 @@ private:
   /**
    * @brief From a list of arguments, process them and call the appropriate
    * function.
-   * @param arg: A vector of strings with the arguments. The first string is the
-   * command.
+   * @param input: The line typed by the user. It starts with the command.
    */
-  void processArgs(std::istream &input);
+  void processArgs(std::string_view input);
 
 public:
   /**
@@ -144,6 +152,30 @@ public:
                        [](auto c) { return Command(Command::Backtracking, {}); });
   }
 
+  static consteval auto parse_held_karp() {
+    using parsum::string_p;
+    return parsum::map(parsum::ws0() >> string_p("held-karp") >> parsum::ws0(),
+                       [](auto c) { return Command(Command::HeldKarp, {}); });
+  }
+
+  /// The budget is kept as the word typed, so Runtime::handleHeldKarp() can
+  /// reject the ones that are not a positive number in range
+  static consteval auto parse_held_karp_budget() {
+    using parsum::string_p;
+    auto word = parsum::map(
+            parsum::take_while1([](char const &c) { return !parsum::is_whitespace(c); }),
+            [](std::string_view word) {
+              return CommandLineValue(CommandLineValue::String, std::string(word));
+            });
+    return parsum::map(
+            parsum::ws0() >> string_p("held-karp") >> parsum::ws1() >>
+                          word >> parsum::ws0(),
+            [](auto inp) {
+              auto [a, b, c, budget, d] = inp;
+              return Command(Command::HeldKarp, {budget});
+            });
+  }
+
   static consteval auto parse_triangular() {
     using parsum::string_p;
     return parsum::map(parsum::ws0() >> string_p("triangular") >> parsum::ws0(),
@@ -168,9 +200,17 @@ public:
             });
   }
 
+  static consteval auto parse_cache() {
+    using parsum::string_p;
+    return parsum::map(parsum::ws0() >> string_p("cache") >> parsum::ws0(),
+                       [](auto c) { return Command(Command::Cache, {}); });
+  }
+
   static consteval auto parse_cmd() {
     return parse_quit() | parse_help()
-           | parse_count() | parse_backtracking() | parse_triangular() | parse_heuristic() | parse_disconnected();
+           | parse_count() | parse_backtracking() | parse_held_karp_budget() | parse_held_karp()
+           | parse_triangular() | parse_heuristic() | parse_disconnected()
+           | parse_cache();
   }
 
   void printHelp();
@@ -181,11 +221,15 @@ public:
 
   void handleBacktracking();
 
+  void handleHeldKarp(Command &cmd);
+
   void handleTriangular();
 
   void handleHeuristic();
 
   void handleDisconnected(Command &cmd);
+
+  void handleCache();
 };
 
 #endif // DA2324_PRJ1_G163_RUNTIME_H
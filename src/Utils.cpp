@@ -55,18 +55,12 @@ double Clock::getTime() const {
 
 // Terminal Utils ==============================================================
 
-unsigned Utils::countLines(const std::string &path) {
-  std::ifstream file(path, std::ios::in | std::ios::binary);
-  return std::count(std::istreambuf_iterator<char>(file),
-                    std::istreambuf_iterator<char>(), '\n');
-}
-
-void Utils::printLoading(unsigned current, unsigned total,
+void Utils::printLoading(uint64_t current, uint64_t total,
                          const std::string &message) {
   float percentage = std::round((float)current / total * 100);
   std::cout.flush();
-  std::cout << "\r" << message << ": " << current / 1000 << "K / "
-            << total / 1000 << "K (" << percentage << "%)     ";
+  std::cout << "\r" << message << ": " << current / 1000 << "KB / "
+            << total / 1000 << "KB (" << percentage << "%)     ";
 }
 
 void Utils::clearLine() {
@@ -93,86 +87,107 @@ double Utils::haversineDistance(double lat1, double lon1, double lat2,
   double aux = pow(sin(delta_lat / 2), 2) +
                cos(lat1) * cos(lat2) * pow(sin(delta_lon / 2), 2);
   double c = 2.0 * atan2(sqrt(aux), sqrt(1 - aux));
-  double const R = 6371000.0; // Earth radius in meters
 
-  return R * c;
+  return EARTH_RADIUS * c;
 }
 
-void Utils::prim(Graph<Info> &g) {
+void Utils::prim(const CSRGraph &g, uint32_t start, Workspace &ws) {
 
-  for (auto &[id, v] : g.getVertexSet()) {
-    v.setVisited(false);
-    v.setDist(INF);
-    v.setPath(UINT64_MAX);
+  for (uint32_t v = 0; v < ws.size(); ++v) {
+    ws.visited[v] = false;
+    ws.dist[v] = INF;
+    ws.path[v] = UINT32_MAX;
   }
 
-  Vertex<Info> &vertex = g.findVertex(0); // start with vertex 0
-  vertex.setDist(0);
+  ws.dist[start] = 0;
 
-  MutablePriorityQueue<Vertex<Info>> q;
-  q.insert(&vertex);
+  WorkspaceQueue q(ws);
+  q.insert(start);
 
   while (!q.empty()) {
 
-    Vertex<Info> *v = q.extractMin();
-    v->setVisited(true);
+    uint32_t v = q.extractMin();
+    ws.visited[v] = true;
 
-    for (auto &[destId, e] : v->getAdj()) {
-      Vertex<Info> &u = g.findVertex(destId);
+    auto dests = g.neighbours(v);
+    auto weights = g.weights(v);
+    for (uint64_t k = 0; k < dests.size(); ++k) {
+      uint32_t u = dests[k];
 
-      if (!u.isVisited() && e.getWeight() < u.getDist()) {
+      double w = WeightTraits<Weight>::load(weights[k]);
+      if (!ws.visited[u] && w < ws.dist[u]) {
 
-        if (u.getDist() == INF)
-          q.insert(&u);
-        else
-          q.decreaseKey(&u);
+        bool queued = ws.dist[u] != INF;
+        ws.dist[u] = w;
+        ws.path[u] = v;
 
-        u.setDist(e.getWeight());
-        u.setPath(v->getId());
+        if (!queued)
+          q.insert(u);
+        else
+          q.decreaseKey(u);
       }
     }
   }
 }
 
-std::vector<uint64_t> Utils::MSTdfs(Graph<Info> &g) {
-  std::vector<uint64_t> res;
-  for (auto &[id, v] : g.getVertexSet())
-    v.setVisited(false);
+void Utils::prim(const DistanceMatrix &m, uint32_t start, Workspace &ws) {
+  for (uint32_t v = 0; v < ws.size(); ++v) {
+    ws.visited[v] = false;
+    ws.dist[v] = INF;
+    ws.path[v] = UINT32_MAX;
+  }
+  ws.dist[start] = 0;
+
+  // Dense variant: a linear scan for the minimum beats a heap when E ~ V^2
+  for (uint32_t steps = 0; steps < m.size(); ++steps) {
+    uint32_t v = UINT32_MAX;
+    double min = INF;
+    for (uint32_t u = 0; u < m.size(); ++u) {
+      if (!ws.visited[u] && ws.dist[u] < min) {
+        min = ws.dist[u];
+        v = u;
+      }
+    }
+    if (v == UINT32_MAX)
+      break; // The remaining vertices are unreachable
+    ws.visited[v] = true;
+
+    const Weight *row = m.row(v);
+    for (uint32_t u = 0; u < m.size(); ++u) {
+      double w = WeightTraits<Weight>::load(row[u]);
+      if (!ws.visited[u] && w < ws.dist[u]) {
+        ws.dist[u] = w;
+        ws.path[u] = v;
+      }
+    }
+  }
+}
 
-  Vertex<Info> &first = g.findVertex(0);
+std::vector<uint32_t> Utils::MSTdfs(const CSRGraph &g, uint32_t start,
+                                    Workspace &ws) {
+  std::vector<uint32_t> res;
+  res.reserve(g.getNumVertex());
+  for (uint32_t v = 0; v < ws.size(); ++v)
+    ws.visited[v] = false;
 
-  MSTdfsVisit(first, res, g);
+  MSTdfsVisit(start, res, g, ws);
 
-  for (auto &[id, v] : g.getVertexSet())
-    if (!v.isVisited())
-      MSTdfsVisit(v, res, g);
+  for (uint32_t v = 0; v < g.getNumVertex(); ++v)
+    if (!ws.visited[v])
+      MSTdfsVisit(v, res, g, ws);
 
   return res;
 }
 
-void Utils::MSTdfsVisit(Vertex<Info> &v, std::vector<uint64_t> &res,
-                        Graph<Info> &g) {
-  v.setVisited(true);
-
-  res.push_back(v.getId());
+void Utils::MSTdfsVisit(uint32_t v, std::vector<uint32_t> &res,
+                        const CSRGraph &g, Workspace &ws) {
+  ws.visited[v] = true;
 
-  for (auto &[destId, e] : v.getAdj()) {
-    Vertex<Info> &u = g.findVertex(destId);
+  res.push_back(v);
 
-    if (u.getPath()) {
-      if (u.getPath() == v.getId()) {
-        if (!u.isVisited()) {
-          MSTdfsVisit(u, res, g);
-        }
-      }
+  for (uint32_t u : g.neighbours(v)) {
+    if (ws.path[u] == v && !ws.visited[u]) {
+      MSTdfsVisit(u, res, g, ws);
     }
   }
 }
-
-double Utils::weight(uint64_t v, uint64_t u, Graph<Info> &g) {
-  Edge<Info> *e = g.findEdge(v, u);
-
-  if (e)
-    return e->getWeight();
-  return g.findVertex(v).getInfo().distance(g.findVertex(u).getInfo());
-}
@@ -8,6 +8,9 @@
 #include <random>
 #include "data/Info.h"
 #include "data/Graph.hpp"
+#include "data/CSRGraph.h"
+#include "data/DistanceMatrix.h"
+#include "data/Workspace.hpp"
 
 /**
  * @brief Auxiliary functions
@@ -16,9 +19,7 @@
 
 class Utils {
 public:
-  static unsigned countLines(const std::string &path);
-
-  static void printLoading(unsigned current, unsigned total, const std::string &path);
+  static void printLoading(uint64_t current, uint64_t total, const std::string &path);
 
   static void clearLine();
 
@@ -34,13 +35,13 @@ public:
     return v[d(gen)];
   }
 
-  static void prim(Graph<Info> &g);
+  static void prim(const CSRGraph &g, uint32_t start, Workspace &ws);
 
-  static std::vector<uint64_t> MSTdfs(Graph<Info> &g);
+  static void prim(const DistanceMatrix &m, uint32_t start, Workspace &ws);
 
-  static void MSTdfsVisit(Vertex<Info> &v, std::vector<uint64_t> &res, Graph<Info> &g);
+  static std::vector<uint32_t> MSTdfs(const CSRGraph &g, uint32_t start, Workspace &ws);
 
-  static double weight(uint64_t v, uint64_t u, Graph<Info> &g);
+  static void MSTdfsVisit(uint32_t v, std::vector<uint32_t> &res, const CSRGraph &g, Workspace &ws);
 };
 
 
@@ -0,0 +1,114 @@
+#include "CSRGraph.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+CSRGraph::CSRGraph(Graph<Info> &g) {
+  auto &vertexSet = g.getVertexSet();
+  uint32_t n = vertexSet.size();
+
+  infos.reserve(n);
+  for (uint32_t i = 0; i < n; ++i)
+    infos.push_back(vertexSet.at(i).getInfo());
+
+  offsetsData.resize(n + 1, 0);
+  for (uint32_t i = 0; i < n; ++i)
+    offsetsData[i + 1] = offsetsData[i] + vertexSet.at(i).getAdj().size();
+  targetsData.resize(offsetsData.back());
+  edgeWeightsData.resize(offsetsData.back());
+  edgeIdsData.resize(offsetsData.back());
+  numEdgeIds = g.getNumEdges();
+
+  std::vector<std::pair<uint32_t, uint32_t>> row;
+  for (uint32_t i = 0; i < n; ++i) {
+    row.clear();
+    for (auto &[dest, e] : vertexSet.at(i).getAdj())
+      row.emplace_back(dest, e);
+    std::sort(row.begin(), row.end());
+    for (uint64_t k = 0; k < row.size(); ++k) {
+      targetsData[offsetsData[i] + k] = row[k].first;
+      edgeWeightsData[offsetsData[i] + k] =
+          g.getEdge(row[k].second).getWeight();
+      edgeIdsData[offsetsData[i] + k] = row[k].second;
+    }
+  }
+
+  offsets = offsetsData;
+  targets = targetsData;
+  edgeWeights = edgeWeightsData;
+  edgeIds = edgeIdsData;
+  buildUnitVectors();
+}
+
+void CSRGraph::buildUnitVectors() {
+  uint32_t n = infos.size();
+  unitX.assign(n, std::numeric_limits<double>::quiet_NaN());
+  unitY.assign(n, std::numeric_limits<double>::quiet_NaN());
+  unitZ.assign(n, std::numeric_limits<double>::quiet_NaN());
+  for (uint32_t v = 0; v < n; ++v) {
+    std::optional<double> lat = infos[v].getLat(), lon = infos[v].getLon();
+    if (lat.has_value() && lon.has_value())
+      DistanceKernel::toUnitVector(lat.value(), lon.value(), unitX[v],
+                                   unitY[v], unitZ[v]);
+  }
+}
+
+uint32_t CSRGraph::getNumVertex() const { return infos.size(); }
+
+uint64_t CSRGraph::getNumEdges() const { return targets.size(); }
+
+uint32_t CSRGraph::getNumEdgeIds() const { return numEdgeIds; }
+
+bool CSRGraph::isComplete() const {
+  uint64_t pairs = targets.size();
+  for (uint32_t v = 0; v < getNumVertex(); ++v)
+    if (findEdge(v, v))
+      --pairs;
+  return pairs >= (uint64_t) getNumVertex() * (getNumVertex() - 1);
+}
+
+const Info &CSRGraph::getInfo(uint32_t v) const { return infos[v]; }
+
+uint64_t CSRGraph::edgeBegin(uint32_t v) const { return offsets[v]; }
+
+uint32_t CSRGraph::getDest(uint64_t e) const { return targets[e]; }
+
+double CSRGraph::getWeight(uint64_t e) const {
+  return WeightTraits<Weight>::load(edgeWeights[e]);
+}
+
+uint32_t CSRGraph::getEdgeId(uint64_t e) const { return edgeIds[e]; }
+
+std::span<const uint32_t> CSRGraph::neighbours(uint32_t v) const {
+  return {targets.data() + offsets[v], targets.data() + offsets[v + 1]};
+}
+
+std::span<const Weight> CSRGraph::weights(uint32_t v) const {
+  return {edgeWeights.data() + offsets[v], edgeWeights.data() + offsets[v + 1]};
+}
+
+std::optional<uint64_t> CSRGraph::findEdge(uint32_t v, uint32_t u) const {
+  auto first = targets.begin() + offsets[v];
+  auto last = targets.begin() + offsets[v + 1];
+  auto itr = std::lower_bound(first, last, u);
+  if (itr == last || *itr != u)
+    return {};
+  return itr - targets.begin();
+}
+
+double CSRGraph::distance(uint32_t v, uint32_t u) const {
+  double c = chord(v, u);
+  if (std::isnan(c))
+    return infos[v].distance(infos[u]); // throws on the missing coordinates
+  return DistanceKernel::chordToDistance(c);
+}
+
+void CSRGraph::chordRow(uint32_t v, double *out) const {
+  DistanceKernel::chordRow(unitX[v], unitY[v], unitZ[v], unitX.data(),
+                           unitY.data(), unitZ.data(), unitX.size(), out);
+}
+
+void CSRGraph::distanceRow(uint32_t v, double *out) const {
+  DistanceKernel::distanceRow(unitX[v], unitY[v], unitZ[v], unitX.data(),
+                              unitY.data(), unitZ.data(), unitX.size(), out);
+}
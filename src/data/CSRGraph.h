@@ -0,0 +1,181 @@
+#ifndef DA2324_PRJ2_G163_CSRGRAPH_H
+#define DA2324_PRJ2_G163_CSRGRAPH_H
+
+#include "DistanceKernel.h"
+#include "Graph.hpp"
+#include "Info.h"
+#include "Weight.hpp"
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+/**
+ * @brief Immutable compressed-sparse-row snapshot of a Graph<Info>.
+ * @details The vertices of the graph must be keyed by their dense indices
+ * (0..V-1, see IdMap). The adjacency of every vertex is stored contiguously,
+ * sorted by destination index. Algorithms iterate plain arrays instead of
+ * walking the hash maps of the mutable Graph.
+ * The arrays are either owned by the snapshot or mapped from a binary
+ * Snapshot file, so it can be moved but not copied. The weights are stored as
+ * Weight (see Weight.hpp).
+ * The coordinates of every vertex are also converted once to a point on the
+ * unit sphere, so distances between vertices need no trigonometry besides a
+ * single asin.
+ */
+class CSRGraph {
+public:
+  CSRGraph() = default;
+
+  CSRGraph(CSRGraph &&) = default;
+
+  CSRGraph &operator=(CSRGraph &&) = default;
+
+  CSRGraph(const CSRGraph &) = delete;
+
+  CSRGraph &operator=(const CSRGraph &) = delete;
+
+  /**
+   * @brief Builds the snapshot from a loaded graph
+   * @note Time Complexity: O(V + E log E)
+   */
+  explicit CSRGraph(Graph<Info> &g);
+
+  /**
+   * @brief Number of vertices
+   */
+  [[nodiscard]] uint32_t getNumVertex() const;
+
+  /**
+   * @brief Number of stored (directed) adjacency entries
+   */
+  [[nodiscard]] uint64_t getNumEdges() const;
+
+  /**
+   * @brief Number of distinct edges (an undirected edge counts once)
+   */
+  [[nodiscard]] uint32_t getNumEdgeIds() const;
+
+  /**
+   * @brief Whether every pair of distinct vertices has an edge
+   * @details Self-loops are not counted, and a row never has the same
+   * destination twice.
+   * @note Time Complexity: O(V log V)
+   */
+  [[nodiscard]] bool isComplete() const;
+
+  /**
+   * @brief Information stored in the vertex at a dense index
+   */
+  [[nodiscard]] const Info &getInfo(uint32_t v) const;
+
+  /**
+   * @brief Position of the first adjacency entry of a vertex
+   * @details Entries of v are in the range [edgeBegin(v), edgeBegin(v + 1)).
+   */
+  [[nodiscard]] uint64_t edgeBegin(uint32_t v) const;
+
+  /**
+   * @brief Destination index of an adjacency entry
+   */
+  [[nodiscard]] uint32_t getDest(uint64_t e) const;
+
+  /**
+   * @brief Weight of an adjacency entry
+   */
+  [[nodiscard]] double getWeight(uint64_t e) const;
+
+  /**
+   * @brief Id of the edge of an adjacency entry
+   * @details Both adjacency entries of an undirected edge share the same id,
+   * in the range [0, getNumEdgeIds()).
+   */
+  [[nodiscard]] uint32_t getEdgeId(uint64_t e) const;
+
+  /**
+   * @brief Destinations of every edge leaving a vertex, sorted
+   */
+  [[nodiscard]] std::span<const uint32_t> neighbours(uint32_t v) const;
+
+  /**
+   * @brief Weights of every edge leaving a vertex, parallel to neighbours()
+   * @details As stored: read them with WeightTraits<Weight>::load().
+   */
+  [[nodiscard]] std::span<const Weight> weights(uint32_t v) const;
+
+  /**
+   * @brief Adjacency entry of the edge between two vertices
+   * @note Time Complexity: O(log deg(v))
+   * @return The entry position, or an empty optional if there is no such edge
+   */
+  [[nodiscard]] std::optional<uint64_t> findEdge(uint32_t v, uint32_t u) const;
+
+  /**
+   * @brief Great-circle distance between two vertices, in meters
+   * @details Same value as Info::distance(), computed from the precomputed
+   * unit vectors.
+   * @note Time Complexity: O(1)
+   * @throws std::bad_optional_access If a vertex has no coordinates
+   */
+  [[nodiscard]] double distance(uint32_t v, uint32_t u) const;
+
+  /**
+   * @brief Squared length of the chord between two vertices on the unit sphere
+   * @details Grows with the distance, so it can replace it when distances are
+   * only compared. NaN if a vertex has no coordinates.
+   * @note Time Complexity: O(1)
+   */
+  [[nodiscard]] double chord(uint32_t v, uint32_t u) const {
+    double dx = unitX[v] - unitX[u];
+    double dy = unitY[v] - unitY[u];
+    double dz = unitZ[v] - unitZ[u];
+    return dx * dx + dy * dy + dz * dz;
+  }
+
+  /**
+   * @brief Squared chords from a vertex to every vertex (see chord())
+   * @param out Array with room for getNumVertex() values
+   * @note Time Complexity: O(V), vectorized (see DistanceKernel)
+   */
+  void chordRow(uint32_t v, double *out) const;
+
+  /**
+   * @brief Distances from a vertex to every vertex, in meters (NaN for
+   * vertices without coordinates)
+   * @param out Array with room for getNumVertex() values
+   * @note Time Complexity: O(V)
+   */
+  void distanceRow(uint32_t v, double *out) const;
+
+private:
+  friend class Snapshot;
+
+  /**
+   * @brief Fills the unit vectors from the coordinates in infos
+   * @note Time Complexity: O(V)
+   */
+  void buildUnitVectors();
+
+  /// Start of each vertex's adjacency (size = V + 1)
+  std::span<const uint64_t> offsets;
+  /// Destination index of each adjacency entry
+  std::span<const uint32_t> targets;
+  /// Weight of each adjacency entry
+  std::span<const Weight> edgeWeights;
+  /// Edge id of each adjacency entry
+  std::span<const uint32_t> edgeIds;
+  /// Storage of the arrays above, unless they are mapped from a file
+  std::vector<uint64_t> offsetsData;
+  std::vector<uint32_t> targetsData;
+  std::vector<Weight> edgeWeightsData;
+  std::vector<uint32_t> edgeIdsData;
+  /// Number of distinct edge ids
+  uint32_t numEdgeIds = 0;
+  /// Information of each vertex
+  std::vector<Info> infos;
+  /// Coordinates of each vertex as a point on the unit sphere (NaN if the
+  /// vertex has none)
+  std::vector<double> unitX, unitY, unitZ;
+};
+
+#endif // DA2324_PRJ2_G163_CSRGRAPH_H
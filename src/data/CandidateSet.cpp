@@ -0,0 +1,67 @@
+#include "CandidateSet.h"
+#include <algorithm>
+
+/// Orders a heap of candidates with the heaviest on top
+static bool lighter(const Candidate &a, const Candidate &b) {
+  return a.weight < b.weight;
+}
+
+CandidateSet::CandidateSet(uint32_t k) : k(k) {}
+
+void CandidateSet::add(uint32_t v, uint32_t u, double weight) {
+  if (v == u || k == 0)
+    return;
+  uint32_t needed = std::max(v, u) + 1;
+  if (sizes.size() < needed) {
+    // Grow geometrically, as the vertices show up one at a time
+    uint32_t cap = std::max<uint32_t>(needed, sizes.size() * 3 / 2);
+    sizes.resize(cap, 0);
+    heaps.resize((uint64_t) cap * k);
+  }
+  numVertex = std::max(numVertex, needed);
+  offer(v, u, weight);
+  offer(u, v, weight);
+}
+
+void CandidateSet::offer(uint32_t v, uint32_t u, double weight) {
+  Candidate *heap = heaps.data() + (uint64_t) v * k;
+  uint32_t &size = sizes[v];
+  for (uint32_t i = 0; i < size; ++i) {
+    if (heap[i].dest == u) { // repeated edge: keep the lightest
+      if (weight < heap[i].weight) {
+        heap[i].weight = weight;
+        std::make_heap(heap, heap + size, lighter);
+      }
+      return;
+    }
+  }
+  if (size < k) {
+    heap[size++] = {weight, u};
+    std::push_heap(heap, heap + size, lighter);
+  } else if (weight < heap[0].weight) {
+    std::pop_heap(heap, heap + size, lighter);
+    heap[size - 1] = {weight, u};
+    std::push_heap(heap, heap + size, lighter);
+  }
+}
+
+std::span<const Candidate> CandidateSet::get(uint32_t v) const {
+  if (v >= sizes.size())
+    return {};
+  return {heaps.data() + (uint64_t) v * k, sizes[v]};
+}
+
+bool CandidateSet::contains(uint32_t v, uint32_t u) const {
+  return std::ranges::any_of(get(v),
+                             [u](const Candidate &c) { return c.dest == u; });
+}
+
+uint64_t CandidateSet::getNumEdges() const {
+  uint64_t res = 0;
+  forEachEdge([&res](uint32_t, uint32_t, double) { ++res; });
+  return res;
+}
+
+uint32_t CandidateSet::getNumVertex() const { return numVertex; }
+
+uint32_t CandidateSet::getK() const { return k; }
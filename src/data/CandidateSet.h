@@ -0,0 +1,87 @@
+#ifndef DA2324_PRJ2_G163_CANDIDATESET_H
+#define DA2324_PRJ2_G163_CANDIDATESET_H
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+/// Edge kept as a candidate of a vertex
+struct Candidate {
+  double weight;
+  uint32_t dest; /// Dense index of the other endpoint
+};
+
+/**
+ * @brief The k lightest edges of every vertex, kept while streaming the edges.
+ * @details Every vertex owns k slots of one flat array, holding a max-heap of
+ * its lightest edges so far: a new edge either fills a free slot or replaces
+ * the heaviest one. Memory is O(V * k), no matter how many edges are offered.
+ */
+class CandidateSet {
+public:
+  /**
+   * @brief Constructor
+   * @param k Number of edges kept per vertex
+   */
+  explicit CandidateSet(uint32_t k);
+
+  /**
+   * @brief Offers an undirected edge to both of its endpoints
+   * @note Time Complexity: O(k)
+   */
+  void add(uint32_t v, uint32_t u, double weight);
+
+  /**
+   * @brief The edges kept for a vertex, in no particular order
+   */
+  [[nodiscard]] std::span<const Candidate> get(uint32_t v) const;
+
+  /**
+   * @brief Whether u is a candidate of v
+   * @note Time Complexity: O(k)
+   */
+  [[nodiscard]] bool contains(uint32_t v, uint32_t u) const;
+
+  /**
+   * @brief Calls fn(v, u, weight) once for every undirected edge kept by
+   * either of its endpoints
+   * @details An edge kept by both endpoints is only visited from the lower
+   * one.
+   * @note Time Complexity: O(V * k^2)
+   */
+  template <typename F> void forEachEdge(F fn) const {
+    for (uint32_t v = 0; v < numVertex; ++v)
+      for (const Candidate &c : get(v))
+        if (v < c.dest || !contains(c.dest, v))
+          fn(v, c.dest, c.weight);
+  }
+
+  /**
+   * @brief Number of edges visited by forEachEdge()
+   * @note Time Complexity: O(V * k^2)
+   */
+  [[nodiscard]] uint64_t getNumEdges() const;
+
+  /**
+   * @brief Number of vertices with a slot (the highest index offered + 1)
+   */
+  [[nodiscard]] uint32_t getNumVertex() const;
+
+  /**
+   * @brief Number of edges kept per vertex
+   */
+  [[nodiscard]] uint32_t getK() const;
+
+private:
+  uint32_t k;
+  uint32_t numVertex = 0;
+  /// k slots per vertex
+  std::vector<Candidate> heaps;
+  /// Number of slots in use per vertex
+  std::vector<uint32_t> sizes;
+
+  /// Offers a directed edge to v
+  void offer(uint32_t v, uint32_t u, double weight);
+};
+
+#endif // DA2324_PRJ2_G163_CANDIDATESET_H
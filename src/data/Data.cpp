@@ -1,232 +1,545 @@
 #include "Data.h"
 #include "../Utils.h"
 #include "Graph.hpp"
+#include "MappedFile.h"
+#include "Snapshot.h"
+#include "Workspace.hpp"
+#include <algorithm>
+#include <atomic>
 #include <cfloat>
 #include <cmath>
 #include <cstdint>
-#include <filesystem>
 #include <fstream>
-#include <sstream>
 #include <string>
+#include <string_view>
+#include <thread>
 
 // Constructors
 // ====================================================================================================
 
-std::istringstream Data::prepareCsv(const std::string &path) {
-  std::ifstream file(path, std::ios::in | std::ios::binary);
-  const auto size = std::filesystem::file_size(path);
-  std::string file_contents(size, '\0');
-  file.read(file_contents.data(), size);
-  std::istringstream input(file_contents);
-  return input;
+/// Edges parsed from a chunk of edges.csv
+struct EdgeChunk {
+  EdgeReader edges;
+  /// Lines of the chunk (counting from 1) that are not a valid edge
+  std::vector<uint64_t> failed;
+  /// Number of lines in the chunk
+  uint64_t lines = 0;
+};
+
+/**
+ * @brief Parses the edges in a chunk of edges.csv
+ * @param progress Number of bytes parsed so far by every chunk
+ * @param report Whether to print the progress (only one chunk should)
+ */
+void parseEdgeChunk(std::string_view text, EdgeChunk &chunk,
+                    std::atomic<uint64_t> &progress, uint64_t total,
+                    const std::string &path, bool report) {
+  EdgeReader &reader = chunk.edges = EdgeReader(text);
+  uint64_t reported = 0;
+  for (auto status = reader.next(); status != EdgeReader::End;
+       status = reader.next()) {
+    if (chunk.lines++ % 10000 == 0) {
+      uint64_t done = progress += reader.offset() - reported;
+      reported = reader.offset();
+      if (report)
+        Utils::printLoading(done, total, "Loading " + path);
+    }
+    if (status == EdgeReader::Mismatch)
+      chunk.failed.push_back(chunk.lines);
+  }
 }
 
-bool Data::saveEdge(std::vector<CsvValues> const &line, Graph<Info> &g) {
-  auto orig = line[0].get_int();
-  auto dest = line[1].get_int();
-  auto dist = line[2].get_flt();
-  if (orig.has_value() && dest.has_value() && dist.has_value()) {
-    uint64_t orig_id = orig.value();
-    uint64_t dest_id = dest.value();
-    double distance = dist.value();
-    Vertex<Info> &o = g.findOrAddVertex(orig_id, Info(orig_id));
-    Vertex<Info> &d = g.findOrAddVertex(dest_id, Info(dest_id));
-    g.addBidirectionalEdge(o, d, distance);
-    return true;
-  } else {
-    return false;
-  }
+void Data::saveNodes(const NodeReader &reader, GraphBuilder<Info> &builder,
+                     IdMap &ids) {
+  const auto &id = reader.column<0>();
+  const auto &longitude = reader.column<1>();
+  const auto &latitude = reader.column<2>();
+  for (size_t i = 0; i < reader.size(); ++i)
+    builder.addVertex(ids.intern(id[i]),
+                      Info(id[i], longitude[i], latitude[i]));
 }
 
-bool Data::saveNode(std::vector<CsvValues> const &line, Graph<Info> &g) {
-  auto id = line[0].get_int();
-  auto longitude = line[1].get_flt();
-  auto latitude = line[2].get_flt();
-  if (id.has_value() && longitude.has_value() && latitude.has_value()) {
-    g.addVertex(Info(id.value(), longitude.value(), latitude.value()),
-                id.value());
-    return true;
-  } else {
-    return false;
+void Data::saveEdges(const EdgeReader &reader, GraphBuilder<Info> &builder,
+                     IdMap &ids) {
+  const auto &orig = reader.column<0>();
+  const auto &dest = reader.column<1>();
+  const auto &weight = reader.column<2>();
+  for (size_t i = 0; i < reader.size(); ++i) {
+    uint32_t o = ids.intern(orig[i]);
+    uint32_t d = ids.intern(dest[i]);
+    if (!builder.hasVertex(o))
+      builder.addVertex(o, Info(orig[i]));
+    if (!builder.hasVertex(d))
+      builder.addVertex(d, Info(dest[i]));
+    builder.addEdge(o, d, weight[i]);
   }
 }
 
-void Data::parseCsv(const std::string &path, Graph<Info> &graph,
-                    const savefn_t saveFn) {
-  constexpr auto parser = parse_line().to_fn();
-  unsigned num_lines = Utils::countLines(path);
-  std::istringstream input = prepareCsv(path);
-  auto res = parsum::Result<CsvLine, parsum::ParseError>(CsvLine());
+void Data::parseNodes(const std::string &path, GraphBuilder<Info> &builder,
+                      IdMap &ids) {
+  MappedFile file(path);
+  NodeReader reader(file.view());
   uint64_t l = 0;
-  while ((res = parser(input)).has_val) {
-    std::vector<CsvValues> line = res.ok.get_data();
+  for (auto status = reader.next(); status != NodeReader::End;
+       status = reader.next()) {
     if (l++ % 10000 == 0) {
-      Utils::printLoading(l, num_lines, "Loading " + path);
+      Utils::printLoading(reader.offset(), file.view().size(),
+                          "Loading " + path);
     }
-    if (!saveFn(line, graph) && l > 1)
+    if (status == NodeReader::Mismatch && l > 1)
       error("Failed to parse line " + std::to_string(l) + " in " + path);
   }
   Utils::clearLine();
+  saveNodes(reader, builder, ids);
 }
 
-Data::Data(const std::string &edge_filename) {
-  this->g = Graph<Info>();
-  parseCsv(edge_filename, this->g, saveEdge);
-}
+void Data::parseEdges(const std::string &path, GraphBuilder<Info> &builder,
+                      IdMap &ids, unsigned threads) {
+  MappedFile file(path);
+  std::string_view text = file.view();
+
+  // Split the file in (roughly) equal chunks, ending at line boundaries
+  threads = std::max(1u, threads);
+  std::vector<std::string_view> texts;
+  size_t begin = 0;
+  for (unsigned t = 1; t <= threads && begin < text.size(); ++t) {
+    size_t end = text.size() * t / threads;
+    if (end < begin)
+      end = begin;
+    end = t == threads ? text.size() : text.find('\n', end);
+    end = end == std::string_view::npos ? text.size() : end + 1;
+    texts.push_back(text.substr(begin, end - begin));
+    begin = end;
+  }
 
-Data::Data(const std::string &edge_filename, const std::string &node_filename) {
-  this->g = Graph<Info>();
-  parseCsv(node_filename, this->g, saveNode);
-  parseCsv(edge_filename, this->g, saveEdge);
+  // Parse every chunk concurrently (the first one in this thread)
+  std::vector<EdgeChunk> chunks(texts.size());
+  std::atomic<uint64_t> progress = 0;
+  std::vector<std::thread> workers;
+  for (uint64_t c = 1; c < texts.size(); ++c)
+    workers.emplace_back(parseEdgeChunk, texts[c], std::ref(chunks[c]),
+                         std::ref(progress), text.size(), std::cref(path),
+                         false);
+  if (!texts.empty())
+    parseEdgeChunk(texts[0], chunks[0], progress, text.size(), path, true);
+  for (std::thread &worker : workers)
+    worker.join();
+  Utils::clearLine();
+
+  // Merge the chunks in order, so the indices are the same for any number of
+  // threads
+  uint64_t numEdges = 0;
+  for (const EdgeChunk &chunk : chunks)
+    numEdges += chunk.edges.size();
+  builder.reserveEdges(numEdges);
+  uint64_t firstLine = 0;
+  for (EdgeChunk &chunk : chunks) {
+    for (uint64_t l : chunk.failed)
+      if (firstLine + l > 1) // The header is not an edge
+        error("Failed to parse line " + std::to_string(firstLine + l) +
+              " in " + path);
+    saveEdges(chunk.edges, builder, ids);
+    chunk.edges = EdgeReader(); // release the columns
+    firstLine += chunk.lines;
+  }
 }
 
-Graph<Info> &Data::getGraph() { return g; }
+void Data::parseCandidates(const std::string &path,
+                           GraphBuilder<Info> &builder, IdMap &ids,
+                           uint32_t k) {
+  std::ifstream file(path, std::ios::in | std::ios::binary);
+  file.seekg(0, std::ios::end);
+  uint64_t total = file.tellg();
+  file.seekg(0, std::ios::beg);
 
-// Functions
-// ====================================================================================================
+  CandidateSet set(k);
+  EdgeReader::row_type row;
+  uint64_t l = 0;
+  CsvTokenizer::for_each_line(
+      file, STREAM_BLOCK_SIZE, [&](std::string_view text, uint64_t offset) {
+        if (l++ % 10000 == 0)
+          Utils::printLoading(offset, total, "Loading " + path);
+        if (!EdgeReader::parse_row(text, row)) {
+          if (l > 1) // The header is not an edge
+            error("Failed to parse line " + std::to_string(l) + " in " + path);
+          return;
+        }
+        auto [orig, dest, weight] = row;
+        uint32_t o = ids.intern(orig);
+        uint32_t d = ids.intern(dest);
+        if (!builder.hasVertex(o))
+          builder.addVertex(o, Info(orig));
+        if (!builder.hasVertex(d))
+          builder.addVertex(d, Info(dest));
+        set.add(o, d, weight);
+      });
+  Utils::clearLine();
 
-std::vector<std::reference_wrapper<const Edge<Info>>>
-generatePossibleEdges(Graph<Info> &g, Vertex<Info> &v,
-                      const std::vector<uint64_t> &path) {
-  std::vector<std::reference_wrapper<const Edge<Info>>> possibleEdges;
-  if (path.size() ==
-      g.getNumVertex() -
-          1) { // If all vertices have been visited, add edge to start
-    for (const auto &e : v.getAdj()) {
-      if (e.first == START_VERTEX) {
-        possibleEdges.push_back(std::ref(e.second));
-        break;
-      }
-    }
-  } else {
-    for (const auto &e : v.getAdj()) { // Add all edges that their destination
-                                       // vertex hasn't been visited yet
-      if (e.first == START_VERTEX)
-        continue;
-      if (std::find(path.begin(), path.end(), e.first) != path.end())
-        continue;
-      possibleEdges.push_back(std::ref(e.second));
-    }
+  builder.reserveEdges(set.getNumEdges());
+  set.forEachEdge([&](uint32_t v, uint32_t u, double weight) {
+    builder.addEdge(v, u, weight);
+  });
+}
+
+void Data::load(const std::string &edge_filename,
+                const std::string &node_filename, unsigned threads,
+                uint32_t candidates) {
+  GraphBuilder<Info> builder;
+  if (!node_filename.empty())
+    parseNodes(node_filename, builder, this->ids);
+  this->candidates = candidates;
+  if (candidates > 0)
+    parseCandidates(edge_filename, builder, this->ids, candidates);
+  else
+    parseEdges(edge_filename, builder, this->ids, threads);
+  {
+    // Every allocation of the graph comes from the arena, and is released at
+    // once when leaving this scope. The pool recycles the blocks freed in the
+    // meantime.
+    std::pmr::monotonic_buffer_resource arena;
+    std::pmr::unsynchronized_pool_resource pool(
+        {POOL_BLOCKS_PER_CHUNK, POOL_LARGEST_BLOCK}, &arena);
+    Graph<Info> g = builder.build(&pool);
+    builder = GraphBuilder<Info>(); // the triples are no longer needed
+    this->csr = CSRGraph(g);
   }
-  return possibleEdges;
+  buildMatrix();
+  pickMetric();
 }
 
-TSPResult btDFS(Graph<Info> &g, const TSPResult &p, Vertex<Info> &v,
-                double &bestCost) {
-  auto possibleEdges = generatePossibleEdges(g, v, p.path);
-  TSPResult bestResult = {DBL_MAX, {}};
+void Data::buildMatrix() {
+  if (DistanceMatrix::isDense(this->csr)) {
+    this->matrix = DistanceMatrix(this->csr);
+    info("The graph is dense, using a distance matrix.");
+  }
+}
 
-  // Base cases
-  if (p.path.size() == g.getNumVertex()) {
-    if (p.cost < bestCost)
-      bestCost = p.cost;
-    return {p.cost, p.path}; // Hamiltonian cycle complete
+void Data::pickMetric() {
+  uint32_t n = csr.getNumVertex();
+  bool coordinates = false;
+  for (uint32_t v = 0; v < n && !coordinates; ++v) {
+    const Info &i = csr.getInfo(v);
+    coordinates = i.getLat().has_value() && i.getLon().has_value();
   }
+  if (!coordinates || csr.isComplete())
+    implicitMetric = ImplicitMetric::None;
+  else if (planar)
+    implicitMetric = ImplicitMetric::Euclidean;
+  else
+    implicitMetric = ImplicitMetric::Haversine;
+}
+
+template <typename F> auto Data::withMetric(F fn) const {
+  if (!specialized)
+    return fn(getOracle());
+  if (matrix)
+    return withImplicit(MatrixEdges(matrix.value()), fn);
+  return withImplicit(SparseEdges(csr), fn);
+}
 
-  // Bounding
-  if (p.cost >= bestCost)
-    return bestResult;
-
-  // Generate results and pick the best one
-  for (std::reference_wrapper<const Edge<Info>> e : possibleEdges) {
-    double nextCost = p.cost + e.get().getWeight();
-    auto nextPath = p.path;
-    Vertex<Info> &nextVertex = g.findVertex(e.get().getDest());
-    nextPath.push_back(nextVertex.getId());
-    TSPResult next = {nextCost, nextPath};
-    auto result = btDFS(g, next, nextVertex, bestCost);
-    if (result < bestResult)
-      bestResult = result;
+template <typename Edges, typename F>
+auto Data::withImplicit(Edges edges, F fn) const {
+  switch (implicitMetric) {
+  case ImplicitMetric::Haversine:
+    return fn(Metric(csr, edges, HaversineCoordinates(csr, cache.get())));
+  case ImplicitMetric::Euclidean:
+    return fn(Metric(csr, edges, PlanarCoordinates(csr)));
+  default:
+    return fn(Metric(csr, edges, NoCoordinates()));
   }
+}
+
+Data::Data(const std::string &edge_filename, unsigned threads,
+           uint32_t candidates) {
+  load(edge_filename, "", threads, candidates);
+}
+
+Data::Data(const std::string &edge_filename, const std::string &node_filename,
+           unsigned threads, uint32_t candidates) {
+  load(edge_filename, node_filename, threads, candidates);
+}
+
+std::optional<Data> Data::fromSnapshot(const std::string &path,
+                                       uint64_t *checksum) {
+  Data d;
+  uint64_t sum;
+  if (!Snapshot::read(path, d.snapshot, d.csr, d.ids, sum, d.candidates))
+    return {};
+  if (checksum)
+    *checksum = sum;
+  d.buildMatrix();
+  d.pickMetric();
+  return d;
+}
+
+bool Data::writeSnapshot(const std::string &path, uint64_t checksum) const {
+  return Snapshot::write(path, this->csr, this->ids, checksum,
+                         this->candidates);
+}
+
+const IdMap &Data::getIds() const { return ids; }
+
+const CSRGraph &Data::getCSR() const { return csr; }
 
-  return bestResult;
+uint32_t Data::getCandidates() const { return candidates; }
+
+const DistanceMatrix *Data::getMatrix() const {
+  return matrix ? &matrix.value() : nullptr;
+}
+
+DistanceOracle Data::getOracle() const {
+  return {csr, getMatrix(), cache.get(), implicitMetric};
 }
 
-TSPResult Data::backtracking() {
-  Vertex<Info> &start = g.findVertex(START_VERTEX);
-  TSPResult p = {0, {}};
-  auto bestCost = DBL_MAX;
+DistanceCache::Stats Data::getCacheStats() const { return cache->getStats(); }
+
+ImplicitMetric Data::getImplicitMetric() const { return implicitMetric; }
+
+void Data::setSpecialized(bool specialized) { this->specialized = specialized; }
 
-  TSPResult res = btDFS(g, p, start, bestCost);
-  res.path.insert(res.path.begin(), START_VERTEX);
-  return res;
+void Data::setPlanar(bool planar) {
+  this->planar = planar;
+  pickMetric();
+}
+
+void Data::setThreads(unsigned threads) {
+  this->threads = std::max(1u, threads);
+}
+
+// Functions
+// ====================================================================================================
+
+/// Tour (possibly partial) built by the algorithms, in dense indices
+struct Tour {
+  double cost;
+  std::vector<uint32_t> path;
+
+  bool operator<(const Tour &res) const { return this->cost < res.cost; }
+};
+
+/**
+ * @brief State of a backtracking search, allocated once per run
+ * @details The visited vertices are a bitset and the current path is a single
+ * stack that is overwritten in place, so exploring a node allocates nothing.
+ * The best tour found so far is copied to its own buffer.
+ */
+template <typename M> class BacktrackingSearch {
+public:
+  BacktrackingSearch(const M &d, uint32_t start)
+      : d(d), n(d.getGraph().getNumVertex()), start(start),
+        visited((n + 63) / 64, 0), path(n + 1), best(n + 1) {
+    path[0] = path[n] = best[n] = start;
+    mark(start);
+  }
+
+  /**
+   * @brief Explores every tour starting at the start vertex
+   * @return The best tour, or an empty path if there is none
+   */
+  Tour run() {
+    search(start, 1, 0);
+    if (bestCost == DBL_MAX)
+      return {DBL_MAX, {}};
+    return {bestCost, best};
+  }
+
+  /**
+   * @brief Number of nodes of the search tree explored
+   */
+  [[nodiscard]] uint64_t getNodes() const { return nodes; }
+
+private:
+  const M &d;
+  uint32_t n;
+  uint32_t start;
+  std::vector<uint64_t> visited;
+  /// path[0..depth) is the current path
+  std::vector<uint32_t> path;
+  std::vector<uint32_t> best;
+  double bestCost = DBL_MAX;
+  uint64_t nodes = 0;
+
+  [[nodiscard]] bool isVisited(uint32_t v) const {
+    return visited[v >> 6] >> (v & 63) & 1;
+  }
+
+  void mark(uint32_t v) { visited[v >> 6] |= 1ull << (v & 63); }
+
+  void unmark(uint32_t v) { visited[v >> 6] &= ~(1ull << (v & 63)); }
+
+  void search(uint32_t v, uint32_t depth, double cost) {
+    ++nodes;
+    if (depth == n) { // If all vertices have been visited, go back to start
+      auto weight = d.edge(v, start);
+      if (weight && cost + weight.value() < bestCost) {
+        bestCost = cost + weight.value();
+        std::copy(path.begin(), path.begin() + n, best.begin());
+      }
+      return;
+    }
+
+    d.forEachEdge(v, [&](uint32_t dest, double weight, uint64_t) {
+      // Bounding: skip visited vertices and paths already costlier than the best
+      if (!isVisited(dest) && cost + weight < bestCost) {
+        mark(dest);
+        path[depth] = dest;
+        search(dest, depth + 1, cost + weight);
+        unmark(dest);
+      }
+      return true;
+    });
+  }
+};
+
+TSPResult Data::backtracking(uint64_t *nodes) const {
+  uint32_t start = ids.find(START_VERTEX).value();
+
+  Tour res = withMetric([&](const auto &d) {
+    BacktrackingSearch search(d, start);
+    Tour tour = search.run();
+    if (nodes)
+      *nodes = search.getNodes();
+    return tour;
+  });
+  if (res.path.empty())
+    res.path.push_back(start);
+  return {res.cost, ids.toIds(res.path)};
+}
+
+std::optional<TSPResult> Data::heldKarp(uint64_t budget) const {
+  uint32_t n = csr.getNumVertex();
+  if (n > HELD_KARP_MAX_VERTICES || HeldKarp::memory(n) > budget)
+    return {};
+  uint32_t start = ids.find(START_VERTEX).value();
+
+  return withMetric([&](const auto &d) -> TSPResult {
+    std::vector<float> weights((uint64_t) n * n,
+                               std::numeric_limits<float>::infinity());
+    for (uint32_t v = 0; v < n; ++v)
+      d.forEachEdge(v, [&](uint32_t dest, double weight, uint64_t) {
+        weights[(uint64_t) v * n + dest] = (float) weight;
+        return true;
+      });
+
+    std::vector<uint32_t> path = HeldKarp(n, std::move(weights)).solve(start, threads);
+    if (path.empty())
+      return {DBL_MAX, ids.toIds({start})};
+    double cost = 0;
+    for (uint32_t i = 0; i + 1 < path.size(); ++i)
+      cost += d.edge(path[i], path[i + 1]).value();
+    return {cost, ids.toIds(path)};
+  });
 }
 
 // ====================================================================================================
 
-TSPResult Data::triangular() {
+TSPResult Data::triangular() const {
+  uint32_t start = ids.find(START_VERTEX).value();
+  Workspace ws(csr.getNumVertex());
+
   // Prim's algorithm - Minimum Spanning Tree
-  Utils::prim(g);
+  if (matrix)
+    Utils::prim(matrix.value(), start, ws);
+  else
+    Utils::prim(csr, start, ws);
 
   // DFS - Depth First Search in the MST
-  std::vector<uint64_t> path = Utils::MSTdfs(g);
+  std::vector<uint32_t> path = Utils::MSTdfs(csr, start, ws);
 
   // Calculate the cost and the path
-  double totalCost = 0;
-
-  for (int i = 0; i < path.size() - 1; i++) {
-    double cost = Utils::weight(path[i], path[i + 1], g);
-    totalCost += cost;
-  }
+  double totalCost = withMetric([&](const auto &d) {
+    double cost = 0;
+    for (size_t i = 0; i + 1 < path.size(); i++)
+      cost += d.weight(path[i], path[i + 1]);
 
-  // Deal with the last edge (returning to the beginning)
-  totalCost += Utils::weight(path[path.size() - 1], path[0], g);
+    // Deal with the last edge (returning to the beginning)
+    return cost + d.weight(path[path.size() - 1], path[0]);
+  });
 
   // Add the first vertex to the end of the path
-  path.push_back(g.findVertex(path[0]).getId());
+  path.push_back(path[0]);
 
-  return TSPResult{totalCost, path};
+  return TSPResult{totalCost, ids.toIds(path)};
 }
 
 // ====================================================================================================
 
-double calc_weight(Graph<Info> &root, uint64_t src, uint64_t dst) {
-  auto &vertex_set = root.getVertexSet();
-  Edge<Info> *ed = root.findEdge(src, dst);
-  double weight = 0;
-  if (ed != nullptr) {
-    weight = ed->getWeight();
-  } else {
-    weight = vertex_set[src].getInfo().distance(vertex_set[dst].getInfo());
-  }
-  return weight;
-}
-
-TSPResult heuristic_impl(Graph<Info> &root) {
+/**
+ * @param candidates Whether the graph only has the candidate edges: they are
+ * tried first, falling back to every vertex when all of them were visited
+ */
+template <typename M>
+Tour heuristic_impl(const M &d, uint32_t start, Workspace &ws,
+                    bool candidates) {
+  const CSRGraph &root = d.getGraph();
   double cost = 0;
   double min = DBL_MAX;
-  uint64_t selected = 0;
-  auto &vertex_set = root.getVertexSet();
-  std::vector<uint64_t> path;
-  path.reserve(root.getVertexSet().size() + 1);
-  path.push_back(0);
-  vertex_set[0].setProcessing(true);
-  for (uint64_t i = 0; i < vertex_set.size() - 1; ++i) {
-    for (uint64_t j = 0; j < vertex_set.size(); ++j) {
-      if (vertex_set[j].isProcessing())
-        continue;
-      if (j == path.back())
-        continue;
-      double weight = calc_weight(root, path.back(), j);
-      if (weight < min) {
-        min = weight;
-        selected = j;
+  uint32_t selected = 0;
+  uint32_t n = root.getNumVertex();
+  std::vector<uint32_t> path;
+  path.reserve(n + 1);
+  path.push_back(start);
+  ws.processing[start] = true;
+  bool complete = root.isComplete();
+  ws.row.resize(n);
+  for (uint32_t i = 0; i < n - 1; ++i) {
+    if (candidates) {
+      d.forEachEdge(path.back(), [&](uint32_t dest, double weight, uint64_t) {
+        if (!ws.processing[dest] && weight < min) {
+          min = weight;
+          selected = dest;
+        }
+        return true;
+      });
+    }
+    if (min == DBL_MAX) {
+      // Vertices without an edge are compared by their implicit keys, and
+      // only the nearest one has its distance computed
+      double nearestChord = DBL_MAX;
+      uint32_t nearest = n;
+      if (!complete)
+        d.implicitKeys(path.back(), ws.row.data());
+      for (uint32_t j = 0; j < n; ++j) {
+        if (ws.processing[j])
+          continue;
+        if (auto weight = d.edge(path.back(), j)) {
+          if (weight.value() < min) {
+            min = weight.value();
+            selected = j;
+          }
+        } else {
+          if (nearest == n || ws.row[j] < nearestChord) {
+            nearestChord = ws.row[j];
+            nearest = j;
+          }
+        }
+      }
+      if (nearest != n) {
+        double weight = d.implicit(path.back(), nearest);
+        if (weight < min || (weight == min && nearest < selected)) {
+          min = weight;
+          selected = nearest;
+        }
       }
     }
     path.push_back(selected);
-    vertex_set[selected].setProcessing(true);
+    ws.processing[selected] = true;
     cost += min;
     min = DBL_MAX;
   }
-  cost += calc_weight(root, path.back(), 0);
-  path.push_back(0);
-  for (uint64_t i = 0; i < vertex_set.size(); ++i) {
-    vertex_set[i].setProcessing(false);
-  }
+  cost += d.weight(path.back(), start);
+  path.push_back(start);
   return {cost, path};
 }
 
-TSPResult Data::heuristic() { return heuristic_impl(this->g); }
+TSPResult Data::heuristic() const {
+  Workspace ws(csr.getNumVertex());
+  Tour res = withMetric([&](const auto &d) {
+    return heuristic_impl(d, ids.find(START_VERTEX).value(), ws,
+                          candidates > 0);
+  });
+  return {res.cost, ids.toIds(res.path)};
+}
 
 // ====================================================================================================
 
@@ -237,87 +550,87 @@ TSPResult Data::heuristic() { return heuristic_impl(this->g); }
 #define DEGREDACTION_RATE 0.1
 #define DEFAULT_PHEROMONE 0.1
 
-void updatePheromoneLevels(Graph<Info> &g, TSPResult &result) {
+template <typename M>
+void updatePheromoneLevels(const M &d, Workspace &ws, Tour &result) {
   double pheromone = HYPERPARAMETER / result.cost * DEGREDACTION_RATE;
-  for (int i = 0; i < result.path.size() - 1; ++i) {
-    Edge<Info> *e = g.findEdge(result.path[i], result.path[i + 1]);
-    e->setFlow(e->getFlow() + pheromone);
+  for (size_t i = 0; i + 1 < result.path.size(); ++i) {
+    uint64_t e = d.edgeId(result.path[i], result.path[i + 1]).value();
+    ws.flow[e] += pheromone;
   }
 }
 
-TSPResult traverseGraphUsingAnts(Graph<Info> &g, Vertex<Info> &start) {
-  for (auto &[_, i] : g.getVertexSet())
-    i.setVisited(false);
-  TSPResult result = {0, {start.getId()}};
-  uint64_t currentId = start.getId();
+template <typename M>
+Tour traverseGraphUsingAnts(const M &d, Workspace &ws, uint32_t start) {
+  const CSRGraph &g = d.getGraph();
+  for (uint32_t v = 0; v < ws.size(); ++v)
+    ws.visited[v] = false;
+  Tour result = {0, {start}};
+  uint32_t current = start;
 
   // Loop through all vertices
-  for (int steps = 0; steps < g.getNumVertex(); ++steps) {
-    Vertex<Info> &currentNode = g.findVertex(currentId);
-    currentNode.setVisited(true);
-    std::vector<std::reference_wrapper<const Edge<Info>>> possibleEdges;
+  for (uint32_t steps = 0; steps < g.getNumVertex(); ++steps) {
+    ws.visited[current] = true;
+    std::vector<std::pair<uint32_t, double>> possibleEdges;
     std::vector<double> probabilities;
 
     // Calculate probabilities for each edge
-    for (const auto &[dest, e] : currentNode.getAdj()) {
+    d.forEachEdge(current, [&](uint32_t dest, double weight, uint64_t e) {
       // Ignore unwanted edges
-      if (g.findVertex(dest).isVisited()) {
-        if (dest == start.getId() && steps == g.getNumVertex() - 1) {
-          possibleEdges.push_back(std::ref(e));
+      if (ws.visited[dest]) {
+        if (dest == start && steps == g.getNumVertex() - 1) {
+          possibleEdges.emplace_back(dest, weight);
           probabilities.push_back(1);
-          break;
+          return false;
         } else
-          continue;
+          return true;
       }
 
       // Calculate probability
-      double pheromoneLevel = fmax(e.getFlow(), EXPLORATION_CONSTANT);
-      double probability =
-          pow(pheromoneLevel, ALPHA) / pow(e.getWeight(), BETA);
-      possibleEdges.push_back(std::ref(e));
+      double pheromoneLevel = fmax(ws.flow[e], EXPLORATION_CONSTANT);
+      double probability = pow(pheromoneLevel, ALPHA) / pow(weight, BETA);
+      possibleEdges.emplace_back(dest, weight);
       probabilities.push_back(probability);
-    }
+      return true;
+    });
 
     if (possibleEdges.empty()) { // No possible edges
-      updatePheromoneLevels(g, result);
+      updatePheromoneLevels(d, ws, result);
       return {DBL_MAX, result.path};
     }
 
     // Select edge
-    auto &edgeSelected =
-        Utils::weightedRandomElement(possibleEdges, probabilities).get();
-    currentId = edgeSelected.getDest();
-    result.cost += edgeSelected.getWeight();
-    result.path.push_back(currentId);
+    auto [dest, weight] =
+        Utils::weightedRandomElement(possibleEdges, probabilities);
+    current = dest;
+    result.cost += weight;
+    result.path.push_back(current);
   }
 
-  updatePheromoneLevels(g, result);
+  updatePheromoneLevels(d, ws, result);
   return result;
 }
 
 std::optional<TSPResult> Data::disconnected(uint64_t vertexId,
-                                            unsigned iterations) {
+                                            unsigned iterations) const {
   // Set default values
-  for (auto &[_, v] : g.getVertexSet()) {
-    v.setVisited(false);
-    for (auto &[_, e] : v.getAdj())
-      e.setFlow(DEFAULT_PHEROMONE);
-  }
-
-  Vertex<Info> &v = g.findVertex(vertexId);
-  TSPResult bestResult = {DBL_MAX, {}};
-  for (int i = 0; i < iterations; ++i) {
-    TSPResult res = traverseGraphUsingAnts(g, v);
-    std::cout << "Iteration " << i << " : " << res.cost;
-    if (res < bestResult) {
-      bestResult = res;
-      std::cout << " [*]";
+  Workspace ws(csr.getNumVertex());
+  uint32_t v = ids.find(vertexId).value();
+  Tour bestResult = {DBL_MAX, {}};
+  withMetric([&](const auto &d) {
+    ws.flow.assign(d.numEdgeIds(), DEFAULT_PHEROMONE);
+    for (unsigned i = 0; i < iterations; ++i) {
+      Tour res = traverseGraphUsingAnts(d, ws, v);
+      std::cout << "Iteration " << i << " : " << res.cost;
+      if (res < bestResult) {
+        bestResult = res;
+        std::cout << " [*]";
+      }
+      std::cout << "               \r";
+      std::cout.flush();
     }
-    std::cout << "               \r";
-    std::cout.flush();
-  }
+  });
 
   if (bestResult.cost == DBL_MAX)
     return {};
-  return bestResult;
+  return TSPResult{bestResult.cost, ids.toIds(bestResult.path)};
 }
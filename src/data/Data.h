@@ -2,17 +2,40 @@
 #define DA2324_PRJ1_G163_DATA_H
 
 #include "../CSV.hpp"
+#include "CSRGraph.h"
+#include "CandidateSet.h"
+#include "DistanceMatrix.h"
+#include "DistanceOracle.h"
 #include "Graph.hpp"
+#include "GraphBuilder.hpp"
+#include "HeldKarp.h"
+#include "IdMap.h"
 #include "Info.h"
+#include "MappedFile.h"
+#include "Metric.hpp"
 #include <cstdint>
+#include <memory>
+#include <memory_resource>
 #include <optional>
 #include <string>
 #include <variant>
 
-typedef bool (*savefn_t)(std::vector<CsvValues> const &, Graph<Info> &);
+/// Schema of edges.csv: origin, destination and distance
+typedef CsvReader<uint64_t, uint64_t, double> EdgeReader;
+/// Schema of nodes.csv: id, longitude and latitude
+typedef CsvReader<uint64_t, double, double> NodeReader;
 
 #define START_VERTEX 0
 
+/// Largest block (in bytes) recycled by the loading pool
+#define POOL_LARGEST_BLOCK (1 << 16)
+/// Maximum number of blocks the loading pool takes from the arena at once
+#define POOL_BLOCKS_PER_CHUNK 32
+/// Size (in bytes) of the blocks edges.csv is read in when streaming it
+#define STREAM_BLOCK_SIZE (1 << 20)
+/// Default memory budget (in MB) of the Held-Karp algorithm
+#define HELD_KARP_MEMORY 4096
+
 /**
  * @brief Result of the Travelling Salesman Problem
  */
@@ -39,43 +62,187 @@ struct TSPResult {
 /**
  * @brief Data storage and algorithms execution.
  * @details This class is responsible for storing the data and executing the
- * algorithms asked by the Runtime class.
+ * algorithms asked by the Runtime class. The algorithms keep their state in a
+ * Workspace of their own, so they can be called concurrently.
+ * The mutable graph only exists while loading: its storage comes from an arena
+ * that is released in one go once the snapshot is built.
  */
 
 class Data {
 private:
-  /// Graph with the data inside Info objects.
-  Graph<Info> g;
+  /// Mapping of the snapshot the data was read from (if it was).
+  std::unique_ptr<MappedFile> snapshot;
+  /// Mapping between the vertex ids in the csv files and their dense indices.
+  IdMap ids;
+  /// Immutable snapshot of the graph, used by the algorithms.
+  CSRGraph csr;
+  /// Dense weights of the graph (only when the graph is dense enough).
+  std::optional<DistanceMatrix> matrix;
+  /// Number of edges kept per vertex if the edges were streamed (0 if every
+  /// edge was kept).
+  uint32_t candidates = 0;
+  /// Distances between vertices without an edge computed so far, shared by
+  /// every algorithm.
+  std::unique_ptr<DistanceCache> cache = std::make_unique<DistanceCache>();
+  /// How the pairs of vertices without an edge are weighted.
+  ImplicitMetric implicitMetric = ImplicitMetric::None;
+  /// Whether the algorithms use the Metric picked for the graph, or the
+  /// DistanceOracle (which decides on every lookup).
+  bool specialized = true;
+  /// Whether the coordinates are planar instead of latitudes and longitudes.
+  bool planar = false;
+  /// Number of threads of the parallel algorithms.
+  unsigned threads = 1;
+
+  void static saveNodes(const NodeReader &reader, GraphBuilder<Info> &builder,
+                        IdMap &ids);
+  void static saveEdges(const EdgeReader &reader, GraphBuilder<Info> &builder,
+                        IdMap &ids);
+  void parseNodes(const std::string &path, GraphBuilder<Info> &builder,
+                  IdMap &ids);
+  void parseEdges(const std::string &path, GraphBuilder<Info> &builder,
+                  IdMap &ids, unsigned threads);
+  void parseCandidates(const std::string &path, GraphBuilder<Info> &builder,
+                       IdMap &ids, uint32_t k);
+  void load(const std::string &edge_filename, const std::string &node_filename,
+            unsigned threads, uint32_t candidates);
+  void buildMatrix();
+  void pickMetric();
+
+  /**
+   * @brief Calls fn with the Metric of the graph (see Metric.hpp), or with
+   * the DistanceOracle if the metric is not specialized
+   * @return What fn returns
+   */
+  template <typename F> auto withMetric(F fn) const;
+  template <typename Edges, typename F>
+  auto withImplicit(Edges edges, F fn) const;
 
-  std::istringstream prepareCsv(const std::string &path);
-  bool static saveEdge(std::vector<CsvValues> const &line, Graph<Info> &g);
-  bool static saveNode(std::vector<CsvValues> const &line, Graph<Info> &g);
-  void parseCsv(const std::string &path, Graph<Info> &g, const savefn_t saveFn);
+  Data() = default;
 
 public:
   /**
    * @brief Constructor
+   * @param threads Number of threads parsing the edges
+   * @param candidates If not 0, the edges are streamed and only the
+   * candidates lightest edges of every vertex are kept (see CandidateSet)
    */
-  explicit Data(const std::string &edge_filename);
+  explicit Data(const std::string &edge_filename, unsigned threads = 1,
+                uint32_t candidates = 0);
   /**
    * @brief Constructor with coordinates
+   * @param threads Number of threads parsing the edges
+   * @param candidates If not 0, the edges are streamed and only the
+   * candidates lightest edges of every vertex are kept (see CandidateSet)
+   */
+  Data(const std::string &edge_filename, const std::string &node_filename,
+       unsigned threads = 1, uint32_t candidates = 0);
+
+  /**
+   * @brief Reads the data from a binary snapshot, without parsing any csv
+   * @note Time Complexity: O(V + E), or O(V^2) if the graph is dense
+   * @param path Path to a file written by writeSnapshot()
+   * @param checksum If given, set to the checksum of the csv files the
+   * snapshot was built from (see Snapshot::checksum())
+   * @return The data, or an empty optional if the file is not a valid snapshot
+   */
+  static std::optional<Data> fromSnapshot(const std::string &path,
+                                          uint64_t *checksum = nullptr);
+
+  /**
+   * @brief Writes the data to a binary snapshot (see Snapshot)
+   * @param checksum Checksum of the csv files the data was read from
+   * @return False if the file could not be written
    */
-  Data(const std::string &edge_filename, const std::string &node_filename);
+  bool writeSnapshot(const std::string &path, uint64_t checksum) const;
 
   /**
-   * @brief Getter for the graph
+   * @brief Getter for the mapping between vertex ids and dense indices
    */
-  Graph<Info> &getGraph();
+  const IdMap &getIds() const;
+
+  /**
+   * @brief Getter for the immutable snapshot of the graph
+   */
+  const CSRGraph &getCSR() const;
+
+  /**
+   * @brief Number of edges kept per vertex when streaming the edges (0 if
+   * every edge was kept)
+   */
+  uint32_t getCandidates() const;
+
+  /**
+   * @brief Getter for the distance matrix
+   * @return A pointer to the matrix, or nullptr if the graph is stored sparsely
+   */
+  const DistanceMatrix *getMatrix() const;
+
+  /**
+   * @brief Weights between any two vertices: the edge between them, or the
+   * distance between their coordinates (memoized in the cache of the data)
+   */
+  DistanceOracle getOracle() const;
+
+  /**
+   * @brief Hits and misses of the cache of distances between vertices without
+   * an edge
+   */
+  DistanceCache::Stats getCacheStats() const;
+
+  /**
+   * @brief How the pairs of vertices without an edge are weighted
+   * @details None if there are no coordinates or every pair has an edge.
+   * Otherwise haversine, or euclidean if the coordinates were set as planar
+   * (see setPlanar()).
+   */
+  ImplicitMetric getImplicitMetric() const;
+
+  /**
+   * @brief Sets whether the coordinates in nodes.csv are planar (x, y)
+   * coordinates, weighted by the euclidean distance, instead of latitudes and
+   * longitudes (the default)
+   */
+  void setPlanar(bool planar);
+
+  /**
+   * @brief Chooses between the Metric instantiation picked for the graph
+   * (the default) and the DistanceOracle, which decides how to weight a pair
+   * on every lookup. Both give the same results.
+   */
+  void setSpecialized(bool specialized);
+
+  /**
+   * @brief Sets the number of threads of the parallel algorithms (heldKarp())
+   */
+  void setThreads(unsigned threads);
 
   /**
    * @brief Backtracking algorithm to solve the Travelling Salesman Problem
    * @details Bounding:
    * - If the current cost is already higher than the best cost, stop exploring this path
    * - If the current path reaches a vertex that has already been visited, stop exploring this path
+   *
+   * The visited vertices are kept in a bitset and the path in a single stack, so the search does not allocate.
    * @note Time Complexity: O(V!) where V is the number of vertices
+   * @param nodes If given, set to the number of nodes of the search tree explored
    * @return A TSPResult with the cost of the best path and the path itself
    */
-  TSPResult backtracking();
+  TSPResult backtracking(uint64_t *nodes = nullptr) const;
+
+  /**
+   * @brief Held-Karp dynamic programming algorithm to solve the Travelling Salesman Problem
+   * @details Builds the cheapest paths from the start through every subset of the vertices, one subset size at a
+   * time (see HeldKarp), splitting each subset size among the threads set by setThreads(). Like backtracking(), it only uses the edges of the graph. The costs are compared as
+   * floats, so tours within a float rounding of each other may be taken for one another; the cost returned is
+   * the exact one.
+   * @note Time Complexity: O(2^V * V^2 / T) where V is the number of vertices and T the number of threads
+   * @param budget Memory (in bytes) the algorithm may use
+   * @return A TSPResult with the cost of the best path and the path itself, or an empty optional if the
+   * graph has more than HELD_KARP_MAX_VERTICES vertices or the algorithm needs more memory than the budget
+   * (see HeldKarp::memory())
+   */
+  std::optional<TSPResult> heldKarp(uint64_t budget) const;
 
   /**
    * @brief 2-approximation algorithm to approximate the Travelling Salesman Problem
@@ -84,15 +251,17 @@ public:
    * @note Time Complexity: O((V + E) log V) where V is the number of vertices and E is the number of edges
    * @return A TSPResult with the cost of the best path and the path itself
    */
-  TSPResult triangular();
+  TSPResult triangular() const;
 
   /**
    * @brief Nearest Neighbor algorithm to approximate the Travelling Salesman Problem
    * @details Starting at 0, the algorithm chooses the lightest edge to the next vertex until all vertices are visited.
-   * @note Time Complexity: O(V^2) where V is the number of vertices
+   * If only the candidate edges were kept, it looks at those first, and only scans every vertex when all the
+   * candidates of the current one were visited.
+   * @note Time Complexity: O(V^2) where V is the number of vertices (O(V * k) in the best case with candidates)
    * @return A TSPResult with the cost of the best path and the path itself
    */
-  TSPResult heuristic();
+  TSPResult heuristic() const;
 
   /**
    * @brief Ant Colony Optimization algorithm to approximate the Travelling Salesman Problem
@@ -104,7 +273,7 @@ public:
    * @param iterations The number of iterations to run the algorithm
    * @return A TSPResult, if a path was found, or an empty optional if otherwise
    */
-  std::optional<TSPResult> disconnected(uint64_t vertexId, unsigned iterations);
+  std::optional<TSPResult> disconnected(uint64_t vertexId, unsigned iterations) const;
 };
 
 #endif // DA2324_PRJ1_G163_DATA_H
@@ -0,0 +1,82 @@
+#include "DistanceKernel.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define DISTANCE_KERNEL_X86
+#endif
+
+void DistanceKernel::toUnitVector(double lat, double lon, double &x,
+                                  double &y, double &z) {
+  double phi = lat * M_PI / 180.0;
+  double lambda = lon * M_PI / 180.0;
+  x = std::cos(phi) * std::cos(lambda);
+  y = std::cos(phi) * std::sin(lambda);
+  z = std::sin(phi);
+}
+
+double DistanceKernel::chordToDistance(double chord) {
+  // The chord between two points on the unit sphere is 2 * sin(angle / 2)
+  return 2.0 * EARTH_RADIUS * std::asin(std::min(1.0, std::sqrt(chord) / 2.0));
+}
+
+void DistanceKernel::chordRowScalar(double px, double py, double pz,
+                                    const double *x, const double *y,
+                                    const double *z, uint32_t count,
+                                    double *out) {
+  for (uint32_t i = 0; i < count; ++i) {
+    double dx = px - x[i];
+    double dy = py - y[i];
+    double dz = pz - z[i];
+    out[i] = dx * dx + dy * dy + dz * dz;
+  }
+}
+
+#ifdef DISTANCE_KERNEL_X86
+__attribute__((target("avx2"))) void
+DistanceKernel::chordRowAVX2(double px, double py, double pz, const double *x,
+                             const double *y, const double *z, uint32_t count,
+                             double *out) {
+  __m256d vx = _mm256_set1_pd(px);
+  __m256d vy = _mm256_set1_pd(py);
+  __m256d vz = _mm256_set1_pd(pz);
+  uint32_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    __m256d dx = _mm256_sub_pd(vx, _mm256_loadu_pd(x + i));
+    __m256d dy = _mm256_sub_pd(vy, _mm256_loadu_pd(y + i));
+    __m256d dz = _mm256_sub_pd(vz, _mm256_loadu_pd(z + i));
+    // Same operations, in the same order, as the scalar version (no fma)
+    __m256d sum = _mm256_add_pd(_mm256_mul_pd(dx, dx), _mm256_mul_pd(dy, dy));
+    _mm256_storeu_pd(out + i, _mm256_add_pd(sum, _mm256_mul_pd(dz, dz)));
+  }
+  chordRowScalar(px, py, pz, x + i, y + i, z + i, count - i, out + i);
+}
+
+bool DistanceKernel::hasAVX2() { return __builtin_cpu_supports("avx2"); }
+#else
+void DistanceKernel::chordRowAVX2(double px, double py, double pz,
+                                  const double *x, const double *y,
+                                  const double *z, uint32_t count,
+                                  double *out) {
+  chordRowScalar(px, py, pz, x, y, z, count, out);
+}
+
+bool DistanceKernel::hasAVX2() { return false; }
+#endif
+
+void DistanceKernel::chordRow(double px, double py, double pz, const double *x,
+                              const double *y, const double *z, uint32_t count,
+                              double *out) {
+  static const auto kernel = hasAVX2() ? chordRowAVX2 : chordRowScalar;
+  kernel(px, py, pz, x, y, z, count, out);
+}
+
+void DistanceKernel::distanceRow(double px, double py, double pz,
+                                 const double *x, const double *y,
+                                 const double *z, uint32_t count,
+                                 double *out) {
+  chordRow(px, py, pz, x, y, z, count, out);
+  for (uint32_t i = 0; i < count; ++i)
+    out[i] = chordToDistance(out[i]);
+}
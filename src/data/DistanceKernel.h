@@ -0,0 +1,76 @@
+#ifndef DA2324_PRJ2_G163_DISTANCEKERNEL_H
+#define DA2324_PRJ2_G163_DISTANCEKERNEL_H
+
+#include <cstdint>
+
+/// Mean radius of the Earth, in meters
+#define EARTH_RADIUS 6371000.0
+
+/**
+ * @brief Great-circle distances from one point to many.
+ * @details The points are given as structure-of-arrays coordinates on the
+ * unit sphere (see toUnitVector()), so a whole row of distances is computed
+ * by one pass over three contiguous arrays. The row kernels have an AVX2
+ * version, used when the processor supports it (checked once at runtime),
+ * and a portable scalar one. Both give exactly the same results.
+ */
+class DistanceKernel {
+public:
+  /**
+   * @brief Converts coordinates to a point on the unit sphere
+   * @details Takes the coordinates in the same roles as
+   * Utils::haversineDistance, in degrees.
+   */
+  static void toUnitVector(double lat, double lon, double &x, double &y,
+                           double &z);
+
+  /**
+   * @brief Converts the squared chord between two points on the unit sphere
+   * to their great-circle distance, in meters
+   */
+  static double chordToDistance(double chord);
+
+  /**
+   * @brief Squared chords from the point (px, py, pz) to the points
+   * [0, count) of the arrays
+   * @details The squared chord grows with the distance, so a row of chords
+   * is enough when distances are only compared. Points with NaN coordinates
+   * give NaN.
+   * @note Time Complexity: O(count)
+   */
+  static void chordRow(double px, double py, double pz, const double *x,
+                       const double *y, const double *z, uint32_t count,
+                       double *out);
+
+  /**
+   * @brief Great-circle distances, in meters, from the point (px, py, pz) to
+   * the points [0, count) of the arrays
+   * @note Time Complexity: O(count)
+   */
+  static void distanceRow(double px, double py, double pz, const double *x,
+                          const double *y, const double *z, uint32_t count,
+                          double *out);
+
+  /**
+   * @brief Portable version of chordRow()
+   */
+  static void chordRowScalar(double px, double py, double pz, const double *x,
+                             const double *y, const double *z, uint32_t count,
+                             double *out);
+
+  /**
+   * @brief AVX2 version of chordRow()
+   * @note Only call it if hasAVX2() is true
+   */
+  static void chordRowAVX2(double px, double py, double pz, const double *x,
+                           const double *y, const double *z, uint32_t count,
+                           double *out);
+
+  /**
+   * @brief Checks if the processor supports AVX2 (and so if chordRow() uses
+   * it)
+   */
+  static bool hasAVX2();
+};
+
+#endif // DA2324_PRJ2_G163_DISTANCEKERNEL_H
@@ -0,0 +1,21 @@
+#include "DistanceMatrix.h"
+
+DistanceMatrix::DistanceMatrix(const CSRGraph &g) : n(g.getNumVertex()) {
+  dist.assign((uint64_t) n * n, WeightTraits<Weight>::none);
+  for (uint32_t v = 0; v < n; ++v) {
+    Weight *r = dist.data() + (uint64_t) v * n;
+    r[v] = 0;
+    auto dests = g.neighbours(v);
+    auto weights = g.weights(v);
+    for (uint64_t k = 0; k < dests.size(); ++k)
+      if (dests[k] != v) // A self-loop would overwrite the diagonal
+        r[dests[k]] = weights[k];
+  }
+}
+
+bool DistanceMatrix::isDense(const CSRGraph &g) {
+  double n = g.getNumVertex();
+  if (n < 2)
+    return false;
+  return (double) g.getNumEdges() / (n * (n - 1)) >= DENSE_THRESHOLD;
+}
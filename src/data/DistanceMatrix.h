@@ -0,0 +1,72 @@
+#ifndef DA2324_PRJ2_G163_DISTANCEMATRIX_H
+#define DA2324_PRJ2_G163_DISTANCEMATRIX_H
+
+#include "CSRGraph.h"
+#include "Weight.hpp"
+#include <cstdint>
+#include <vector>
+
+/// Minimum edge density (E / (V * (V - 1))) for a graph to be stored densely
+#define DENSE_THRESHOLD 0.9
+
+/**
+ * @brief Dense row-major matrix with the weight of every edge of a graph.
+ * @details Indexed by the dense indices of a CSRGraph. Pairs without an edge
+ * hold INF and the diagonal holds 0. Each row is contiguous, so scanning all
+ * the edges leaving a vertex is a linear pass over memory.
+ * The weights are stored as Weight (see Weight.hpp), so a float or fixed-point
+ * build halves the size of the matrix.
+ */
+class DistanceMatrix {
+public:
+  DistanceMatrix() = default;
+
+  /**
+   * @brief Builds the matrix from the edges of a snapshot
+   * @note Time Complexity: O(V^2 + E)
+   */
+  explicit DistanceMatrix(const CSRGraph &g);
+
+  /**
+   * @brief Checks if a graph is dense enough to be stored in a matrix
+   * @return True if the density of the graph is at least DENSE_THRESHOLD
+   */
+  static bool isDense(const CSRGraph &g);
+
+  /**
+   * @brief Number of vertices (rows and columns)
+   */
+  [[nodiscard]] uint32_t size() const { return n; }
+
+  /**
+   * @brief Weight of the edge between two vertices
+   * @return The weight, or INF if there is no such edge
+   */
+  [[nodiscard]] double at(uint32_t v, uint32_t u) const {
+    return WeightTraits<Weight>::load(dist[(uint64_t) v * n + u]);
+  }
+
+  /**
+   * @brief Checks if there is an edge between two vertices
+   */
+  [[nodiscard]] bool hasEdge(uint32_t v, uint32_t u) const {
+    return v != u && dist[(uint64_t) v * n + u] != WeightTraits<Weight>::none;
+  }
+
+  /**
+   * @brief Weights of every edge leaving a vertex (size = size())
+   * @details As stored: missing edges hold WeightTraits<Weight>::none, and
+   * the others are read with WeightTraits<Weight>::load().
+   */
+  [[nodiscard]] const Weight *row(uint32_t v) const {
+    return dist.data() + (uint64_t) v * n;
+  }
+
+private:
+  /// Number of vertices
+  uint32_t n = 0;
+  /// Weights, row-major (size = n * n)
+  std::vector<Weight> dist;
+};
+
+#endif // DA2324_PRJ2_G163_DISTANCEMATRIX_H
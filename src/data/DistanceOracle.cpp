@@ -0,0 +1,124 @@
+#include "DistanceOracle.h"
+#include "Metric.hpp"
+#include <algorithm>
+
+// DistanceCache ===============================================================
+
+DistanceCache::DistanceCache(uint32_t bits)
+    : bits(bits), slots(std::make_unique<Slot[]>(1ull << bits)) {}
+
+uint64_t DistanceCache::key(uint32_t v, uint32_t u) {
+  // (UINT32_MAX, UINT32_MAX) is not a pair of distinct vertices
+  return ((uint64_t) std::min(v, u) << 32 | std::max(v, u)) + 1;
+}
+
+DistanceCache::Slot &DistanceCache::slot(uint64_t key) const {
+  return slots[(key * 0x9e3779b97f4a7c15ull) >> (64 - bits)];
+}
+
+std::optional<double> DistanceCache::find(uint32_t v, uint32_t u) const {
+  uint64_t k = key(v, u);
+  Slot &s = slot(k);
+  uint64_t version = s.version.load();
+  if (version % 2 == 0 && s.key.load() == k) {
+    double value = s.value.load();
+    // A writer may have filled the slot with another pair meanwhile
+    if (s.version.load() == version) {
+      hits.fetch_add(1, std::memory_order_relaxed);
+      return value;
+    }
+  }
+  misses.fetch_add(1, std::memory_order_relaxed);
+  return {};
+}
+
+void DistanceCache::store(uint32_t v, uint32_t u, double distance) {
+  uint64_t k = key(v, u);
+  Slot &s = slot(k);
+  // Only one writer at a time: the others drop their pair, as it is a cache
+  uint64_t version = s.version.load();
+  if (version % 2 != 0 ||
+      !s.version.compare_exchange_strong(version, version + 1))
+    return;
+  s.key.store(k);
+  s.value.store(distance);
+  s.version.store(version + 2);
+}
+
+uint64_t DistanceCache::capacity() const { return 1ull << bits; }
+
+DistanceCache::Stats DistanceCache::getStats() const {
+  return {hits.load(std::memory_order_relaxed),
+          misses.load(std::memory_order_relaxed)};
+}
+
+// DistanceOracle ==============================================================
+
+DistanceOracle::DistanceOracle(const CSRGraph &g, const DistanceMatrix *m,
+                               DistanceCache *cache, ImplicitMetric metric)
+    : g(&g), m(m), cache(cache), metric(metric) {}
+
+std::optional<double> DistanceOracle::edge(uint32_t v, uint32_t u) const {
+  if (m) {
+    if (m->hasEdge(v, u))
+      return m->at(v, u);
+    return {};
+  }
+  if (auto e = g->findEdge(v, u))
+    return g->getWeight(e.value());
+  return {};
+}
+
+// The implicit weights are the ones of the policies of Metric.hpp, so both
+// give the same results
+
+double DistanceOracle::implicit(uint32_t v, uint32_t u) const {
+  switch (metric) {
+  case ImplicitMetric::Haversine:
+    if (!cache)
+      return g->distance(v, u);
+    return HaversineCoordinates(*g, cache).implicit(v, u);
+  case ImplicitMetric::Euclidean:
+    return PlanarCoordinates(*g).implicit(v, u);
+  default:
+    return NoCoordinates().implicit(v, u);
+  }
+}
+
+double DistanceOracle::weight(uint32_t v, uint32_t u) const {
+  if (auto w = edge(v, u))
+    return w.value();
+  return implicit(v, u);
+}
+
+void DistanceOracle::implicitKeys(uint32_t v, double *out) const {
+  switch (metric) {
+  case ImplicitMetric::Haversine:
+    return HaversineCoordinates(*g, cache).implicitKeys(v, out);
+  case ImplicitMetric::Euclidean:
+    return PlanarCoordinates(*g).implicitKeys(v, out);
+  default:
+    return NoCoordinates().implicitKeys(v, out);
+  }
+}
+
+std::optional<uint64_t> DistanceOracle::edgeId(uint32_t v, uint32_t u) const {
+  if (!m) {
+    if (auto e = g->findEdge(v, u))
+      return g->getEdgeId(e.value());
+    return {};
+  }
+  if (!m->hasEdge(v, u))
+    return {};
+  return (uint64_t) std::min(u, v) * m->size() + std::max(u, v);
+}
+
+uint64_t DistanceOracle::numEdgeIds() const {
+  return m ? (uint64_t) m->size() * m->size() : g->getNumEdgeIds();
+}
+
+ImplicitMetric DistanceOracle::getImplicitMetric() const { return metric; }
+
+const CSRGraph &DistanceOracle::getGraph() const { return *g; }
+
+const DistanceMatrix *DistanceOracle::getMatrix() const { return m; }
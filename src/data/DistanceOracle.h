@@ -0,0 +1,203 @@
+#ifndef DA2324_PRJ2_G163_DISTANCEORACLE_H
+#define DA2324_PRJ2_G163_DISTANCEORACLE_H
+
+#include "CSRGraph.h"
+#include "DistanceMatrix.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <optional>
+
+/**
+ * @brief How the pairs of vertices without an edge are weighted
+ */
+enum class ImplicitMetric {
+  /// There are no coordinates (or every pair has an edge)
+  None,
+  /// Great-circle distance between latitudes and longitudes
+  Haversine,
+  /// Euclidean distance between planar coordinates
+  Euclidean,
+};
+
+/// Default number of slots of a DistanceCache, as a power of 2 (24 bytes each)
+#define DISTANCE_CACHE_BITS 16
+
+/**
+ * @brief Bounded memo of the distances between vertices without an edge.
+ * @details A direct-mapped table: each pair of vertices hashes to a single
+ * slot, and storing a pair evicts whatever the slot held, so the memory never
+ * grows past the initial table. Each slot is a seqlock: a writer claims it by
+ * making its version odd, and a reader only trusts the pair it read if the
+ * version was the same even number before and after. So every algorithm (and
+ * every thread) can share the same cache without locking. A slot that is
+ * being written counts as a miss, and a store to it is dropped.
+ */
+class DistanceCache {
+public:
+  /// Number of lookups that found / did not find their pair
+  struct Stats {
+    uint64_t hits;
+    uint64_t misses;
+  };
+
+  /**
+   * @brief Constructor
+   * @param bits The table has 2^bits slots
+   */
+  explicit DistanceCache(uint32_t bits = DISTANCE_CACHE_BITS);
+
+  /**
+   * @brief Looks up the distance between two vertices (in any order)
+   * @note Time Complexity: O(1)
+   * @return The distance, or an empty optional if it is not cached
+   */
+  [[nodiscard]] std::optional<double> find(uint32_t v, uint32_t u) const;
+
+  /**
+   * @brief Stores the distance between two vertices (in any order)
+   * @note Time Complexity: O(1)
+   */
+  void store(uint32_t v, uint32_t u, double distance);
+
+  /**
+   * @brief Number of slots
+   */
+  [[nodiscard]] uint64_t capacity() const;
+
+  /**
+   * @brief Hits and misses of every lookup so far
+   */
+  [[nodiscard]] Stats getStats() const;
+
+private:
+  struct Slot {
+    /// Even when the slot is stable, odd while a writer fills it
+    std::atomic<uint64_t> version;
+    /// Key of the pair held (0 if none, see key())
+    std::atomic<uint64_t> key;
+    std::atomic<double> value;
+  };
+
+  uint32_t bits;
+  std::unique_ptr<Slot[]> slots;
+  mutable std::atomic<uint64_t> hits = 0;
+  mutable std::atomic<uint64_t> misses = 0;
+
+  /// Key of an unordered pair of vertices, never 0
+  static uint64_t key(uint32_t v, uint32_t u);
+
+  [[nodiscard]] Slot &slot(uint64_t key) const;
+};
+
+/**
+ * @brief Weight of the path between any two vertices of a graph.
+ * @details The weight is the one of the edge between them if there is one.
+ * Otherwise it depends on the ImplicitMetric: the great-circle distance
+ * between their coordinates, which is memoized in a DistanceCache, or the
+ * euclidean distance between planar coordinates. An oracle only holds
+ * pointers, so it is cheap to copy; get one from Data::getOracle().
+ * It decides on every lookup how the graph is stored, so it can stand for any
+ * graph; the solvers also take the Metric instantiations of Metric.hpp, which
+ * decide at compile time.
+ */
+class DistanceOracle {
+public:
+  /**
+   * @brief Constructor
+   * @param m The distance matrix of the graph, if there is one
+   * @param cache Cache of the great-circle distances (none if nullptr)
+   * @param metric How the pairs without an edge are weighted
+   */
+  DistanceOracle(const CSRGraph &g, const DistanceMatrix *m,
+                 DistanceCache *cache = nullptr,
+                 ImplicitMetric metric = ImplicitMetric::Haversine);
+
+  /**
+   * @brief Weight of the edge between two vertices, if there is one
+   * @note Time Complexity: O(1) with a matrix, O(log deg(v)) otherwise
+   */
+  [[nodiscard]] std::optional<double> edge(uint32_t v, uint32_t u) const;
+
+  /**
+   * @brief Distance between two vertices (see ImplicitMetric), ignoring the
+   * edges
+   * @note Time Complexity: O(1)
+   * @throws std::bad_optional_access If a vertex has no coordinates, or the
+   * metric is ImplicitMetric::None
+   */
+  [[nodiscard]] double implicit(uint32_t v, uint32_t u) const;
+
+  /**
+   * @brief Weight of the edge between two vertices, or their implicit()
+   * distance if there is no edge
+   * @note Time Complexity: O(1) with a matrix, O(log deg(v)) otherwise
+   */
+  [[nodiscard]] double weight(uint32_t v, uint32_t u) const;
+
+  /**
+   * @brief Keys from a vertex to every vertex, ordered like implicit(): the
+   * squared chords (see CSRGraph::chordRow()), or the squared planar
+   * distances (NaN where there are no coordinates). Nothing is written if the
+   * metric is ImplicitMetric::None.
+   * @param out Array with room for getNumVertex() values
+   */
+  void implicitKeys(uint32_t v, double *out) const;
+
+  /**
+   * @brief Calls fn(dest, weight, edgeId) for every edge leaving v, until fn
+   * returns false
+   * @details The id identifies the undirected edge, so both directions share
+   * it: its position in the upper triangle of the distance matrix if there is
+   * one, or its edge id in the graph otherwise.
+   */
+  template <typename F> void forEachEdge(uint32_t v, F fn) const {
+    if (m) {
+      const Weight *row = m->row(v);
+      for (uint32_t u = 0; u < m->size(); ++u)
+        if (u != v && row[u] != WeightTraits<Weight>::none &&
+            !fn(u, WeightTraits<Weight>::load(row[u]),
+                (uint64_t) std::min(u, v) * m->size() + std::max(u, v)))
+          return;
+    } else {
+      for (uint64_t e = g->edgeBegin(v); e < g->edgeBegin(v + 1); ++e)
+        if (!fn(g->getDest(e), g->getWeight(e), g->getEdgeId(e)))
+          return;
+    }
+  }
+
+  /**
+   * @brief Id of the edge between two vertices (see forEachEdge()), if there
+   * is one
+   */
+  [[nodiscard]] std::optional<uint64_t> edgeId(uint32_t v, uint32_t u) const;
+
+  /**
+   * @brief Upper bound of the edge ids
+   */
+  [[nodiscard]] uint64_t numEdgeIds() const;
+
+  /**
+   * @brief How the pairs without an edge are weighted
+   */
+  [[nodiscard]] ImplicitMetric getImplicitMetric() const;
+
+  /**
+   * @brief Getter for the graph
+   */
+  [[nodiscard]] const CSRGraph &getGraph() const;
+
+  /**
+   * @brief Getter for the distance matrix (nullptr if there is none)
+   */
+  [[nodiscard]] const DistanceMatrix *getMatrix() const;
+
+private:
+  const CSRGraph *g;
+  const DistanceMatrix *m;
+  DistanceCache *cache;
+  ImplicitMetric metric;
+};
+
+#endif // DA2324_PRJ2_G163_DISTANCEORACLE_H
@@ -0,0 +1,207 @@
+#ifndef DA2324_PRJ2_G163_FLATMAP_HPP
+#define DA2324_PRJ2_G163_FLATMAP_HPP
+
+/**
+ * @file FlatMap.hpp
+ * @brief Open-addressing hash map with Robin Hood probing.
+ * @details Entries are stored inline in a single array (no node per entry),
+ * each next to the probe distance of its slot. Insertions move
+ * entries that are closer to their ideal slot ("rich") to make room for the
+ * ones that are further away ("poor"), which keeps probe sequences short, and
+ * erasures shift the following entries back instead of leaving tombstones.
+ * It provides the subset of the std::unordered_map interface used by the
+ * graph, so it can be plugged in as the adjacency container of a Vertex.
+ * The slots are allocated from a std::pmr::memory_resource (the default one
+ * unless another is given), such as the arena of the graph.
+ */
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory_resource>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Fibonacci hash for integer keys
+ * @details FlatMap uses the high bits of the product, which spreads runs of
+ * consecutive keys (such as dense vertex indices) evenly over the table.
+ */
+struct FlatMapHash {
+  size_t operator()(uint64_t x) const { return x * 0x9E3779B97F4A7C15ULL; }
+};
+
+template <typename K, typename V, typename Hash = FlatMapHash>
+class FlatMap {
+public:
+  using value_type = std::pair<K, V>;
+
+  template <typename Map, typename Value> class Iterator {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = FlatMap::value_type;
+    using difference_type = std::ptrdiff_t;
+    using pointer = Value *;
+    using reference = Value &;
+
+    Iterator(Map *map, size_t i) : map(map), i(i) { skip(); }
+
+    reference operator*() const { return map->slots[i]; }
+
+    pointer operator->() const { return &map->slots[i]; }
+
+    Iterator &operator++() {
+      ++i;
+      skip();
+      return *this;
+    }
+
+    bool operator==(const Iterator &other) const { return i == other.i; }
+
+    bool operator!=(const Iterator &other) const { return i != other.i; }
+
+  private:
+    friend class FlatMap;
+    Map *map;
+    size_t i;
+
+    void skip() {
+      while (i < map->slots.size() && map->slots[i].dist == 0)
+        ++i;
+    }
+  };
+
+  using iterator = Iterator<FlatMap, value_type>;
+  using const_iterator = Iterator<const FlatMap, const value_type>;
+
+  FlatMap() = default;
+
+  explicit FlatMap(std::pmr::memory_resource *res) : slots(res) {}
+
+  iterator begin() { return {this, 0}; }
+
+  iterator end() { return {this, slots.size()}; }
+
+  const_iterator begin() const { return {this, 0}; }
+
+  const_iterator end() const { return {this, slots.size()}; }
+
+  [[nodiscard]] size_t size() const { return count; }
+
+  [[nodiscard]] bool empty() const { return count == 0; }
+
+  void clear() {
+    slots.clear();
+    count = 0;
+  }
+
+  /// Makes room for n entries without rehashing
+  void reserve(size_t n) {
+    size_t cap = 8;
+    while (cap * MAX_LOAD_NUM < n * MAX_LOAD_DEN)
+      cap *= 2;
+    if (cap > slots.size())
+      rehash(cap);
+  }
+
+  iterator find(const K &key) { return {this, findIndex(key)}; }
+
+  const_iterator find(const K &key) const { return {this, findIndex(key)}; }
+
+  std::pair<iterator, bool> try_emplace(const K &key, const V &value) {
+    size_t i = findIndex(key);
+    if (i != slots.size())
+      return {{this, i}, false};
+    return {{this, insertNew(value_type(key, value))}, true};
+  }
+
+  V &operator[](const K &key) { return try_emplace(key, V()).first->second; }
+
+  size_t erase(const K &key) {
+    size_t i = findIndex(key);
+    if (i == slots.size())
+      return 0;
+    // Backward shift: pull the following entries one slot closer to home
+    size_t next = (i + 1) & mask;
+    while (slots[next].dist > 1) {
+      slots[i].kv() = std::move(slots[next].kv());
+      slots[i].dist = slots[next].dist - 1;
+      i = next;
+      next = (next + 1) & mask;
+    }
+    slots[i].dist = 0;
+    --count;
+    return 1;
+  }
+
+private:
+  /// Maximum load factor (MAX_LOAD_NUM / MAX_LOAD_DEN)
+  static constexpr size_t MAX_LOAD_NUM = 7;
+  static constexpr size_t MAX_LOAD_DEN = 8;
+
+  /// Entry and its probe distance. Deriving from the pair lets the distance
+  /// use its tail padding (e.g. 16 bytes instead of 24 for <uint64_t, uint32_t>)
+  struct Slot : value_type {
+    uint8_t dist = 0; /// Probe distance + 1 (0 = empty)
+
+    value_type &kv() { return *this; }
+  };
+  std::pmr::vector<Slot> slots;
+  size_t count = 0;
+  size_t mask = 0;
+  unsigned shift = 64;
+
+  [[nodiscard]] size_t findIndex(const K &key) const {
+    if (count == 0)
+      return slots.size();
+    size_t i = Hash()(key) >> shift;
+    for (uint8_t d = 1; slots[i].dist >= d; ++d) {
+      if (slots[i].first == key)
+        return i;
+      i = (i + 1) & mask;
+    }
+    return slots.size();
+  }
+
+  /// Inserts a key known not to be present, returning its slot
+  size_t insertNew(value_type entry) {
+    if ((count + 1) * MAX_LOAD_DEN > slots.size() * MAX_LOAD_NUM)
+      rehash(slots.empty() ? 8 : slots.size() * 2);
+    K key = entry.first;
+    size_t res = slots.size();
+    size_t i = Hash()(key) >> shift;
+    uint8_t d = 1;
+    while (slots[i].dist != 0) {
+      if (slots[i].dist < d) { // Robin Hood: take the slot of the richer entry
+        std::swap(entry, slots[i].kv());
+        std::swap(d, slots[i].dist);
+        if (res == slots.size())
+          res = i;
+      }
+      i = (i + 1) & mask;
+      if (++d == UINT8_MAX) { // Pathological probe length, grow and retry
+        rehash(slots.size() * 2);
+        insertNew(std::move(entry));
+        return findIndex(key);
+      }
+    }
+    slots[i].kv() = std::move(entry);
+    slots[i].dist = d;
+    ++count;
+    return res == slots.size() ? i : res;
+  }
+
+  void rehash(size_t cap) {
+    std::pmr::vector<Slot> oldSlots(cap, slots.get_allocator());
+    std::swap(oldSlots, slots);
+    mask = cap - 1;
+    shift = 64 - std::countr_zero(cap);
+    count = 0;
+    for (Slot &slot : oldSlots)
+      if (slot.dist != 0)
+        insertNew(std::move(slot.kv()));
+  }
+};
+
+#endif // DA2324_PRJ2_G163_FLATMAP_HPP
@@ -8,33 +8,51 @@
  * @details This implementation uses unordered maps to store vertices and edges,
  * for faster access, compromising memory usage. It also uses a more
  * object-oriented approach, avoiding the use of pointers and dynamic memory.
+ * Every edge is stored once, in the graph, and each vertex only keeps the
+ * index of the edges leaving it. An undirected edge is therefore a single
+ * Edge shared by the adjacency of both endpoints.
+ * All the storage of the graph (vertex set, edge set and adjacencies) is
+ * allocated from a single std::pmr::memory_resource, so an arena can own it and
+ * release it in one go.
  */
 
 #include <cstdint>
+#include <limits>
+#include <memory_resource>
 #include <optional>
 #include <stdexcept>
 #include <unordered_map>
-#include "../../lib/MutablePriorityQueue.h"
+#include <vector>
+#include "FlatMap.hpp"
+#include "Weight.hpp"
 
+#ifndef INF
 #define INF std::numeric_limits<double>::max()
+#endif
 
-template<typename T>
+/// Default adjacency container: destination id -> edge index
+using DefaultAdjacency = FlatMap<uint64_t, uint32_t>;
+
+template<typename T, typename Adj = DefaultAdjacency, typename W = Weight>
 class Graph;
 
-template<typename T>
+template<typename T, typename Adj = DefaultAdjacency>
 class Vertex;
 
-template<typename T>
+template<typename T, typename W = Weight>
 class Edge;
 
 // =================================================================================================
 
-template<typename T>
+/**
+ * @tparam W Type the weight is stored as (see WeightTraits)
+ */
+template<typename T, typename W>
 class Edge {
 private:
   uint64_t orig; /// Origin vertex id
   uint64_t dest; /// Destination vertex id
-  double weight; /// Edge weight
+  W weight;      /// Edge weight, as stored
 
 protected:
   double flow = 0.0;     /// Used for flow-related algorithms
@@ -44,54 +62,61 @@ public:
   Edge() = default;
 
   Edge(uint64_t orig, uint64_t dest, double weight)
-          : orig(orig), dest(dest), weight(weight) {}
+          : orig(orig), dest(dest), weight(WeightTraits<W>::store(weight)) {}
 
   [[nodiscard]] uint64_t getOrig() const { return orig; }
 
   [[nodiscard]] uint64_t getDest() const { return dest; }
 
-  [[nodiscard]] double getWeight() const { return weight; }
+  /// Endpoint of the edge that is not v (for edges shared by both directions)
+  [[nodiscard]] uint64_t getOther(uint64_t v) const {
+    return v == orig ? dest : orig;
+  }
+
+  /// Weight as stored (see WeightTraits)
+  [[nodiscard]] W getWeight() const { return weight; }
 
   [[nodiscard]] double getFlow() const { return flow; }
 
-  void setWeight(double w) { this->weight = w; }
+  void setWeight(double w) { this->weight = WeightTraits<W>::store(w); }
 
   void setFlow(double f) { this->flow = f; }
 };
 
 // =================================================================================================
 
-template<typename T>
+/**
+ * @tparam Adj Adjacency container, mapping a destination id to an edge index.
+ * Must provide the find/end/erase/operator[]/size/reserve subset of
+ * std::unordered_map and be constructible from a std::pmr::memory_resource *
+ * (e.g. std::pmr::unordered_map<uint64_t, uint32_t> or FlatMap).
+ */
+template<typename T, typename Adj>
 class Vertex {
-  friend class Graph<T>;
+  template<typename, typename, typename>
+  friend class Graph;
 
 private:
   uint64_t id; /// Vertex id
   T info;      /// Information stored in the vertex
-  std::unordered_map<uint64_t, Edge<T>> edges; /// Adjacency list
+  Adj edges;   /// Adjacency list (dest -> edge index)
 
 protected:
-  bool visited = false;       // Used by traversal algorithms
-  bool processing = false;    // Used by DAG algorithms
-  double dist = 0.0;          // Used by shortest path algorithms
-  uint64_t path = UINT64_MAX; // Used by shortest path algorithms
-  int queueIndex = 0;         // Used by MutablePriorityQueue
-
-  Edge<T> &addEdge(Vertex<T> &dest, double weight) {
-    edges[dest.getId()] = Edge<T>(this->getId(), dest.getId(), weight);
-    return edges[dest.getId()];
-  }
+  void addEdge(Vertex &dest, uint32_t edge) { edges[dest.getId()] = edge; }
 
-  void removeEdge(Vertex<T> &dest) { edges.erase(dest.getId()); }
+  void removeEdge(Vertex &dest) { edges.erase(dest.getId()); }
 
 public:
   Vertex() = default;
 
-  explicit Vertex(T info, uint64_t id) : info(info), id(id) {}
+  explicit Vertex(T info, uint64_t id,
+                  std::pmr::memory_resource *res =
+                      std::pmr::get_default_resource())
+      : info(info), id(id), edges(res) {}
 
-  Vertex(const Vertex<T> &v) : info(v.info), id(v.id), edges(v.edges) {}
+  Vertex(const Vertex &v) : info(v.info), id(v.id), edges(v.edges) {}
 
-  Vertex<T> &operator=(const Vertex<T> &v) {
+  Vertex &operator=(const Vertex &v) {
     if (this != &v) {
       this->info = v.info;
       this->id = v.id;
@@ -100,95 +125,104 @@ public:
     return *this;
   }
 
-  // Required by MutablePriorityQueue
-  bool operator<(Vertex<T> &vertex) const {
-    return this->dist < vertex.dist;
-  }
-
   [[nodiscard]] T getInfo() const { return info; }
 
   [[nodiscard]] uint64_t getId() const { return id; }
 
-  [[nodiscard]] std::unordered_map<uint64_t, Edge<T>> &getAdj() {
-    return edges;
-  }
-
-  [[nodiscard]] bool isVisited() const { return visited; }
-
-  [[nodiscard]] bool isProcessing() const { return processing; }
-
-  [[nodiscard]] double getDist() const { return dist; }
-
-  [[nodiscard]] uint64_t getPath() const { return path; }
-
-  void setVisited(bool v) { this->visited = v; }
-
-  void setProcessing(bool p) { this->processing = p; }
-
-  void setDist(double d) { this->dist = d; }
-
-  void setPath(uint64_t p) { this->path = p; }
-
-  friend class MutablePriorityQueue<Vertex>;
+  /// Destination id -> index of the edge in Graph::getEdge()
+  [[nodiscard]] Adj &getAdj() { return edges; }
 };
 
 // =================================================================================================
 
-template<typename T>
+/**
+ * @tparam W Type the edge weights are stored as (see WeightTraits)
+ */
+template<typename T, typename Adj, typename W>
 class Graph {
+public:
+  using VertexT = Vertex<T, Adj>;
+  using EdgeT = Edge<T, W>;
+
 private:
-  std::unordered_map<uint64_t, Vertex<T>> vertexSet;
+  std::pmr::memory_resource *resource; /// Where the graph storage comes from
+  std::pmr::unordered_map<uint64_t, VertexT> vertexSet;
+  std::pmr::vector<EdgeT> edgeSet; /// Every edge, stored once
+
+  /// Index of the edge from orig to dest, if there is one
+  std::optional<uint32_t> findEdgeIndex(VertexT &orig, VertexT &dest) {
+    auto &edgs = orig.getAdj();
+    if (auto itr = edgs.find(dest.getId()); itr != edgs.end())
+      return itr->second;
+    return {};
+  }
 
 public:
-  Graph() = default;
+  Graph() : Graph(std::pmr::get_default_resource()) {}
 
-  explicit Graph(unsigned int numVertex) { vertexSet.reserve(numVertex); }
+  /// Graph whose storage is allocated from res, which must outlive it
+  explicit Graph(std::pmr::memory_resource *res)
+      : resource(res), vertexSet(res), edgeSet(res) {}
 
-  [[nodiscard]] std::unordered_map<uint64_t, Vertex<T>> &getVertexSet() {
+  explicit Graph(unsigned int numVertex) : Graph() {
+    vertexSet.reserve(numVertex);
+  }
+
+  [[nodiscard]] std::pmr::unordered_map<uint64_t, VertexT> &getVertexSet() {
     return vertexSet;
   }
 
-  Vertex<T> &addVertex(T info, uint64_t id) {
-    vertexSet[id] = Vertex<T>(info, id);
-    return vertexSet[id];
+  VertexT &addVertex(T info, uint64_t id) {
+    auto [itr, inserted] = vertexSet.try_emplace(id, info, id, resource);
+    if (!inserted)
+      itr->second = VertexT(info, id);
+    return itr->second;
   }
 
   void removeVertex(uint64_t id) { vertexSet.erase(id); }
 
-  Edge<T> &addEdge(Vertex<T> &orig, Vertex<T> &dest, double weight) {
-    return orig.addEdge(dest, weight);
+  /// @note The reference is invalidated by the next edge insertion
+  EdgeT &addEdge(VertexT &orig, VertexT &dest, double weight) {
+    if (auto e = findEdgeIndex(orig, dest)) {
+      edgeSet[e.value()].setWeight(weight);
+      return edgeSet[e.value()];
+    }
+    edgeSet.emplace_back(orig.getId(), dest.getId(), weight);
+    orig.addEdge(dest, edgeSet.size() - 1);
+    return edgeSet.back();
   }
 
-  void removeEdge(Vertex<T> &orig, Vertex<T> &dest) { orig.removeEdge(dest); }
+  /// @note The edge itself stays in the edge set, unreachable from orig
+  void removeEdge(VertexT &orig, VertexT &dest) { orig.removeEdge(dest); }
 
-  void addBidirectionalEdge(Vertex<T> &orig, Vertex<T> &dest, double weight) {
+  void addBidirectionalEdge(VertexT &orig, VertexT &dest, double weight) {
     addEdge(orig, dest, weight);
-    addEdge(dest, orig, weight);
+    dest.addEdge(orig, findEdgeIndex(orig, dest).value());
   }
 
-  Vertex<T> &findVertex(uint64_t id) { return vertexSet.at(id); }
+  /// Makes room for numVertex vertices
+  void reserveVertices(uint32_t numVertex) { vertexSet.reserve(numVertex); }
 
-  bool hasVertex(uint64_t id) {
-    try {
-      vertexSet.at(id);
-      return true;
-    } catch (std::out_of_range &e) {
-      return false;
-    }
-  }
+  /// Makes room for numEdges edges (an undirected edge counts once)
+  void reserveEdges(uint64_t numEdges) { edgeSet.reserve(numEdges); }
+
+  [[nodiscard]] EdgeT &getEdge(uint32_t index) { return edgeSet[index]; }
+
+  /// Number of stored edges (an undirected edge counts once)
+  [[nodiscard]] uint32_t getNumEdges() const { return edgeSet.size(); }
+
+  VertexT &findVertex(uint64_t id) { return vertexSet.at(id); }
+
+  bool hasVertex(uint64_t id) { return vertexSet.contains(id); }
 
-  Vertex<T> &findOrAddVertex(uint64_t id, T info) {
-    if (!hasVertex(id))
-      return addVertex(info, id);
-    else
-      return findVertex(id);
+  VertexT &findOrAddVertex(uint64_t id, T info) {
+    return vertexSet.try_emplace(id, info, id, resource).first->second;
   }
 
-  [[nodiscard]] Edge<T> *findEdge(uint64_t orig, uint64_t dest) {
-    std::unordered_map<uint64_t, Edge<T>> &edgs =
-            this->vertexSet.at(orig).getAdj();
+  [[nodiscard]] EdgeT *findEdge(uint64_t orig, uint64_t dest) {
+    Adj &edgs = this->vertexSet.at(orig).getAdj();
     if (auto itr = edgs.find(dest); itr != edgs.end()) {
-      return &(itr->second);
+      return &edgeSet[itr->second];
     }
     return nullptr;
   }
@@ -0,0 +1,102 @@
+#ifndef DA2324_PRJ2_G163_GRAPHBUILDER_HPP
+#define DA2324_PRJ2_G163_GRAPHBUILDER_HPP
+
+/**
+ * @file GraphBuilder.hpp
+ * @brief Bulk construction of an undirected Graph.
+ * @details Instead of growing the graph one edge at a time, the builder
+ * collects every vertex and (orig, dest, weight) triple first. Building then
+ * counts the degree of each vertex, reserves the exact capacity of the vertex
+ * set, the edge set and every adjacency, and inserts all the edges in a single
+ * pass, so no container is rehashed or reallocated along the way.
+ * Vertices are identified by their dense indices (see IdMap).
+ */
+
+#include "Graph.hpp"
+#include <cstdint>
+#include <memory_resource>
+#include <span>
+#include <vector>
+
+/// Undirected edge waiting to be inserted by a GraphBuilder
+struct EdgeTriple {
+  uint32_t orig; /// Dense index of one endpoint
+  uint32_t dest; /// Dense index of the other endpoint
+  double weight; /// Edge weight
+};
+
+template<typename T, typename Adj = DefaultAdjacency>
+class GraphBuilder {
+private:
+  std::vector<T> infos;         /// Information of each vertex
+  std::vector<uint8_t> present; /// Whether each vertex was added
+  std::vector<EdgeTriple> edges;
+
+public:
+  GraphBuilder() = default;
+
+  /// Adds a vertex, replacing its information if it was already added
+  void addVertex(uint32_t v, T info) {
+    if (v >= infos.size()) {
+      infos.resize(v + 1);
+      present.resize(v + 1, false);
+    }
+    infos[v] = info;
+    present[v] = true;
+  }
+
+  [[nodiscard]] bool hasVertex(uint32_t v) const {
+    return v < present.size() && present[v];
+  }
+
+  /// Makes room for numEdges more edges
+  void reserveEdges(uint64_t numEdges) {
+    edges.reserve(edges.size() + numEdges);
+  }
+
+  /// Adds an undirected edge (both endpoints must be added before building)
+  void addEdge(uint32_t orig, uint32_t dest, double weight) {
+    edges.push_back({orig, dest, weight});
+  }
+
+  /// Adds a batch of undirected edges
+  void addEdges(std::span<const EdgeTriple> batch) {
+    edges.insert(edges.end(), batch.begin(), batch.end());
+  }
+
+  /// Number of edges added so far
+  [[nodiscard]] uint64_t getNumEdges() const { return edges.size(); }
+
+  /**
+   * @brief Builds the graph with every vertex and edge added
+   * @details If an edge is added more than once, the last weight is kept.
+   * @note Time Complexity: O(V + E)
+   * @param res Where the storage of the graph comes from (must outlive it)
+   */
+  Graph<T, Adj> build(std::pmr::memory_resource *res =
+                          std::pmr::get_default_resource()) const {
+    std::vector<uint32_t> degree(infos.size(), 0);
+    for (const EdgeTriple &e : edges) {
+      ++degree[e.orig];
+      if (e.dest != e.orig)
+        ++degree[e.dest];
+    }
+
+    Graph<T, Adj> g(res);
+    g.reserveVertices(infos.size());
+    g.reserveEdges(edges.size());
+    // Keep the vertices at hand instead of hashing both endpoints of each edge
+    std::vector<typename Graph<T, Adj>::VertexT *> vertices(infos.size());
+    for (uint32_t v = 0; v < infos.size(); ++v) {
+      if (!present[v])
+        continue;
+      vertices[v] = &g.addVertex(infos[v], v);
+      vertices[v]->getAdj().reserve(degree[v]);
+    }
+    for (const EdgeTriple &e : edges)
+      g.addBidirectionalEdge(*vertices[e.orig], *vertices[e.dest], e.weight);
+    return g;
+  }
+};
+
+#endif // DA2324_PRJ2_G163_GRAPHBUILDER_HPP
@@ -0,0 +1,191 @@
+#include "HeldKarp.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <thread>
+
+HeldKarp::HeldKarp(uint32_t n, std::vector<float> weights)
+    : n(n), weights(std::move(weights)), binom((uint64_t) (n + 1) * (n + 1), 0) {
+  // Pascal's triangle (the coefficients that overflow are never used, as the
+  // memory of such graphs is refused long before)
+  for (uint32_t a = 0; a <= n; ++a) {
+    binom[a * (n + 1)] = 1;
+    for (uint32_t b = 1; b <= a; ++b)
+      binom[a * (n + 1) + b] =
+          binom[(a - 1) * (n + 1) + b - 1] + binom[(a - 1) * (n + 1) + b];
+  }
+}
+
+uint64_t HeldKarp::choose(uint32_t a, uint32_t b) const {
+  return binom[a * (n + 1) + b];
+}
+
+uint64_t HeldKarp::memory(uint32_t n) {
+  if (n < 2)
+    return 0;
+  uint32_t m = n - 1;
+  // Predecessors of every layer: sum of k * (m choose k) = m * 2^(m - 1)
+  long double bytes = m * std::pow(2.0L, m - 1);
+  // Costs of the two largest layers
+  long double layer = 0, c = 1; // c = m choose k
+  for (uint32_t k = 1; k <= m; ++k) {
+    c = c * (m - k + 1) / k;
+    layer = std::max(layer, c * k);
+  }
+  bytes += 2 * layer * sizeof(float);
+  bytes += (long double) n * n * sizeof(float);
+  bytes += (long double) (n + 1) * (n + 1) * sizeof(uint64_t);
+  if (bytes >= (long double) UINT64_MAX)
+    return UINT64_MAX;
+  return (uint64_t) bytes;
+}
+
+void HeldKarp::unrank(uint64_t rank, uint32_t k, uint32_t m,
+                      uint32_t *p) const {
+  // The largest c with (c choose i) <= rank is the position of the i-th vertex
+  uint32_t c = m;
+  for (uint32_t i = k; i > 0; --i) {
+    do
+      --c;
+    while (choose(c, i) > rank);
+    p[i - 1] = c;
+    rank -= choose(c, i);
+  }
+}
+
+void HeldKarp::solveLayer(const Layer &l, uint64_t begin, uint64_t end) const {
+  uint32_t k = l.k, m = n - 1;
+  // Positions of the vertices of a subset, and the sums that give the rank of
+  // the subset without one of them
+  std::vector<uint32_t> p(k);
+  std::vector<uint64_t> prefix(k + 1), suffix(k + 1);
+
+  unrank(begin, k, m, p.data());
+  uint64_t s = 0;
+  for (uint32_t i = 0; i < k; ++i)
+    s |= 1ull << p[i];
+
+  for (uint64_t rank = begin; rank < end; ++rank) {
+    uint32_t size = 0;
+    for (uint64_t x = s; x; x &= x - 1)
+      p[size++] = __builtin_ctzll(x);
+    // rank(S) = sum of (p[i] choose i + 1). Without p[t], the vertices after
+    // it move down one position.
+    prefix[0] = 0;
+    for (uint32_t i = 0; i < k; ++i)
+      prefix[i + 1] = prefix[i] + choose(p[i], i + 1);
+    suffix[k] = 0;
+    for (uint32_t i = k; i-- > 0;)
+      suffix[i] = suffix[i + 1] + choose(p[i], i);
+
+    float *out = l.cur + rank * k;
+    uint8_t *outPred = l.pred + rank * k;
+    for (uint32_t t = 0; t < k; ++t) {
+      const float *in = l.prev + (prefix[t] + suffix[t + 1]) * (k - 1);
+      const float *into = l.w + (uint64_t) p[t] * (m + 1);
+      float best = std::numeric_limits<float>::infinity();
+      uint8_t bestPred = 0;
+      // Without p[t], the vertices after it are one position down in prev
+      for (uint32_t i = 0; i < t; ++i) {
+        float cost = in[i] + into[p[i]];
+        if (cost < best) {
+          best = cost;
+          bestPred = p[i];
+        }
+      }
+      for (uint32_t i = t + 1; i < k; ++i) {
+        float cost = in[i - 1] + into[p[i]];
+        if (cost < best) {
+          best = cost;
+          bestPred = p[i];
+        }
+      }
+      out[t] = best;
+      outPred[t] = bestPred;
+    }
+
+    // Gosper's hack: next integer with k bits set
+    uint64_t lowest = s & -s, ripple = s + lowest;
+    s = (((ripple ^ s) >> 2) / lowest) | ripple;
+  }
+}
+
+std::vector<uint32_t> HeldKarp::solve(uint32_t start, unsigned threads) const {
+  if (n < 2)
+    return {};
+  // The other vertices are numbered 0..m-1, and the start is m. The weights
+  // are transposed, so the edges into a vertex are contiguous.
+  uint32_t m = n - 1;
+  auto vertex = [&](uint32_t c) {
+    return c == m ? start : c < start ? c : c + 1;
+  };
+  std::vector<float> w((uint64_t) (m + 1) * (m + 1));
+  for (uint32_t a = 0; a <= m; ++a)
+    for (uint32_t b = 0; b <= m; ++b)
+      w[b * (m + 1) + a] = weights[(uint64_t) vertex(a) * n + vertex(b)];
+
+  // Layer k holds (m choose k) subsets of k entries each, and starts at
+  // offset[k] in the predecessors
+  std::vector<uint64_t> offset(m + 2, 0);
+  uint64_t largest = 0;
+  for (uint32_t k = 1; k <= m; ++k) {
+    offset[k + 1] = offset[k] + choose(m, k) * k;
+    largest = std::max(largest, choose(m, k) * k);
+  }
+  std::vector<float> prev(largest), cur(largest);
+  std::vector<uint8_t> pred(offset[m + 1]);
+
+  for (uint32_t c = 0; c < m; ++c) // Layer 1: straight from the start
+    prev[c] = w[c * (m + 1) + m];
+
+  // The subsets of a layer only read the previous layer, so each thread takes
+  // a contiguous range of ranks
+  threads = std::max(1u, threads);
+  std::vector<std::thread> workers;
+  for (uint32_t k = 2; k <= m; ++k) {
+    Layer l = {k, w.data(), prev.data(), cur.data(), pred.data() + offset[k]};
+    uint64_t subsets = choose(m, k);
+    uint64_t chunks = std::min<uint64_t>(
+        threads, (subsets + HELD_KARP_CHUNK - 1) / HELD_KARP_CHUNK);
+    for (uint64_t c = 1; c < chunks; ++c)
+      workers.emplace_back(&HeldKarp::solveLayer, this, std::cref(l),
+                           subsets * c / chunks, subsets * (c + 1) / chunks);
+    solveLayer(l, 0, subsets / chunks);
+    for (std::thread &worker : workers)
+      worker.join();
+    workers.clear();
+    std::swap(prev, cur);
+  }
+
+  // Close the tour
+  float best = std::numeric_limits<float>::infinity();
+  uint32_t last = 0;
+  for (uint32_t c = 0; c < m; ++c) {
+    float cost = prev[c] + w[m * (m + 1) + c];
+    if (cost < best) {
+      best = cost;
+      last = c;
+    }
+  }
+  if (best == std::numeric_limits<float>::infinity())
+    return {};
+
+  // Follow the predecessors back to the start
+  std::vector<uint32_t> path = {start};
+  uint64_t s = (1ull << m) - 1;
+  for (uint32_t k = m; k > 1; --k) {
+    path.push_back(vertex(last));
+    uint64_t rank = 0;
+    uint32_t i = 0;
+    for (uint64_t x = s; x; x &= x - 1, ++i)
+      rank += choose(__builtin_ctzll(x), i + 1);
+    uint32_t t = __builtin_popcountll(s & ((1ull << last) - 1));
+    uint32_t next = pred[offset[k] + rank * k + t];
+    s &= ~(1ull << last);
+    last = next;
+  }
+  path.push_back(vertex(last));
+  path.push_back(start);
+  std::reverse(path.begin(), path.end());
+  return path;
+}
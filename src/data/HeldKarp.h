@@ -0,0 +1,87 @@
+#ifndef DA2324_PRJ2_G163_HELDKARP_H
+#define DA2324_PRJ2_G163_HELDKARP_H
+
+#include <cstdint>
+#include <vector>
+
+/// Minimum number of subsets a thread of HeldKarp::solve() takes per layer
+#define HELD_KARP_CHUNK 4096
+/// Maximum number of vertices of a graph solved by HeldKarp
+#define HELD_KARP_MAX_VERTICES 64
+
+/**
+ * @brief Held-Karp dynamic programming over subsets of vertices.
+ * @details For every subset S of the vertices other than the start, and every
+ * j in S, the table holds the cost of the cheapest path that leaves the start,
+ * visits every vertex of S and ends at j. The subsets are processed in layers
+ * of equal size, and a layer only reads the previous one, so the costs of only
+ * two layers are kept. The predecessors are kept for every layer, to rebuild
+ * the tour at the end.
+ *
+ * The subsets of a layer are enumerated in increasing order (Gosper's hack),
+ * and indexed by their rank in that order, which is computed from a table of
+ * binomial coefficients. The subsets of a layer are independent, so each
+ * thread takes a contiguous range of ranks, and finds its first subset from
+ * the same table. Each entry stores a float cost and a uint8 predecessor.
+ * The subsets are 64-bit masks of the vertices other than the start, so graphs
+ * have at most HELD_KARP_MAX_VERTICES (64) vertices, far more than the memory
+ * allows anyway.
+ */
+class HeldKarp {
+public:
+  /**
+   * @brief Constructor
+   * @param n Number of vertices (at most HELD_KARP_MAX_VERTICES)
+   * @param weights n * n weights, row by row (infinity if there is no edge)
+   */
+  HeldKarp(uint32_t n, std::vector<float> weights);
+
+  /**
+   * @brief Memory (in bytes) solve() needs for a graph
+   * @return The estimate, or UINT64_MAX if it does not fit in 64 bits
+   */
+  static uint64_t memory(uint32_t n);
+
+  /**
+   * @brief Finds the cheapest tour
+   * @note Time Complexity: O(2^V * V^2 / threads) where V is the number of
+   * vertices
+   * @param threads Number of threads processing each layer
+   * @return The tour, starting and ending at start (size = n + 1), or an
+   * empty path if there is none
+   */
+  [[nodiscard]] std::vector<uint32_t> solve(uint32_t start,
+                                            unsigned threads = 1) const;
+
+private:
+  uint32_t n;
+  std::vector<float> weights;
+  /// binom[a * (n + 1) + b] = a choose b
+  std::vector<uint64_t> binom;
+
+  [[nodiscard]] uint64_t choose(uint32_t a, uint32_t b) const;
+
+  /// Tables read and written while processing layer k
+  struct Layer {
+    uint32_t k;
+    /// Transposed weights between the vertices (the start is the last)
+    const float *w;
+    const float *prev;
+    float *cur;
+    /// Predecessors of layer k
+    uint8_t *pred;
+  };
+
+  /**
+   * @brief Positions of the vertices of the subset with a given rank
+   * @param p Array with room for k positions, filled in increasing order
+   */
+  void unrank(uint64_t rank, uint32_t k, uint32_t m, uint32_t *p) const;
+
+  /**
+   * @brief Processes the subsets of a layer with ranks in [begin, end)
+   */
+  void solveLayer(const Layer &l, uint64_t begin, uint64_t end) const;
+};
+
+#endif // DA2324_PRJ2_G163_HELDKARP_H
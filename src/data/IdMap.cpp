@@ -0,0 +1,26 @@
+#include "IdMap.h"
+
+uint32_t IdMap::intern(uint64_t id) {
+  auto [itr, inserted] = index.try_emplace(id, ids.size());
+  if (inserted)
+    ids.push_back(id);
+  return itr->second;
+}
+
+std::optional<uint32_t> IdMap::find(uint64_t id) const {
+  if (auto itr = index.find(id); itr != index.end())
+    return itr->second;
+  return {};
+}
+
+uint64_t IdMap::getId(uint32_t v) const { return ids[v]; }
+
+std::vector<uint64_t> IdMap::toIds(const std::vector<uint32_t> &path) const {
+  std::vector<uint64_t> res;
+  res.reserve(path.size());
+  for (uint32_t v : path)
+    res.push_back(ids[v]);
+  return res;
+}
+
+uint32_t IdMap::size() const { return ids.size(); }
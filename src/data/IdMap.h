@@ -0,0 +1,55 @@
+#ifndef DA2324_PRJ2_G163_IDMAP_H
+#define DA2324_PRJ2_G163_IDMAP_H
+
+#include <cstdint>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Bidirectional mapping between vertex ids and dense indices.
+ * @details Vertex ids in the csv files are arbitrary 64-bit numbers. While
+ * loading, each new id is assigned the next free index (0, 1, 2, ...), so the
+ * rest of the program can store vertices in plain arrays. The original ids are
+ * only needed again when presenting results.
+ */
+class IdMap {
+public:
+  IdMap() = default;
+
+  /**
+   * @brief Index of an id, assigning a new one if the id was never seen
+   * @note Time Complexity: O(1) (amortized)
+   */
+  uint32_t intern(uint64_t id);
+
+  /**
+   * @brief Index of an id
+   * @return The index, or an empty optional if the id was never seen
+   */
+  [[nodiscard]] std::optional<uint32_t> find(uint64_t id) const;
+
+  /**
+   * @brief Original id of an index
+   */
+  [[nodiscard]] uint64_t getId(uint32_t v) const;
+
+  /**
+   * @brief Converts a sequence of indices into their original ids
+   */
+  [[nodiscard]] std::vector<uint64_t>
+  toIds(const std::vector<uint32_t> &path) const;
+
+  /**
+   * @brief Number of ids mapped
+   */
+  [[nodiscard]] uint32_t size() const;
+
+private:
+  /// Index -> original id
+  std::vector<uint64_t> ids;
+  /// Original id -> index
+  std::unordered_map<uint64_t, uint32_t> index;
+};
+
+#endif // DA2324_PRJ2_G163_IDMAP_H
@@ -0,0 +1,48 @@
+#include "MappedFile.h"
+#include <fstream>
+#include <sstream>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define MAPPED_FILE_MMAP
+#endif
+
+MappedFile::MappedFile(const std::string &path) {
+#ifdef MAPPED_FILE_MMAP
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd != -1) {
+    struct stat st {};
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+      void *p = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (p != MAP_FAILED) {
+        madvise(p, st.st_size, MADV_SEQUENTIAL);
+        this->mapping = p;
+        this->size = st.st_size;
+      }
+    }
+    close(fd);
+    if (this->mapping)
+      return;
+  }
+#endif
+  std::ifstream file(path, std::ios::in | std::ios::binary);
+  std::ostringstream contents;
+  contents << file.rdbuf();
+  this->buffer = std::move(contents).str();
+}
+
+MappedFile::~MappedFile() {
+#ifdef MAPPED_FILE_MMAP
+  if (this->mapping)
+    munmap(this->mapping, this->size);
+#endif
+}
+
+std::string_view MappedFile::view() const {
+  if (this->mapping)
+    return {static_cast<const char *>(this->mapping), this->size};
+  return this->buffer;
+}
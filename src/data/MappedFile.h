@@ -0,0 +1,43 @@
+#ifndef DA2324_PRJ2_G163_MAPPEDFILE_H
+#define DA2324_PRJ2_G163_MAPPEDFILE_H
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+/**
+ * @brief Read-only view of the contents of a file.
+ * @details On POSIX systems the file is memory-mapped, so its contents are
+ * read straight from the page cache without being copied. Elsewhere, or if
+ * the mapping fails, the file is read into a buffer instead.
+ */
+class MappedFile {
+public:
+  /**
+   * @brief Maps a file
+   * @details If the file cannot be read, the view is empty.
+   */
+  explicit MappedFile(const std::string &path);
+
+  ~MappedFile();
+
+  MappedFile(const MappedFile &) = delete;
+
+  MappedFile &operator=(const MappedFile &) = delete;
+
+  /**
+   * @brief Contents of the file
+   * @note Valid as long as the MappedFile
+   */
+  [[nodiscard]] std::string_view view() const;
+
+private:
+  /// Start of the mapping (nullptr if the file was read into buffer)
+  void *mapping = nullptr;
+  /// Size of the mapping
+  size_t size = 0;
+  /// Contents of the file, when it is not mapped
+  std::string buffer;
+};
+
+#endif // DA2324_PRJ2_G163_MAPPEDFILE_H
@@ -0,0 +1,215 @@
+#ifndef DA2324_PRJ2_G163_METRIC_HPP
+#define DA2324_PRJ2_G163_METRIC_HPP
+
+/**
+ * @file Metric.hpp
+ * @brief Compile-time policies for the weight between two vertices.
+ * @details A Metric combines where the explicit edges are stored (SparseEdges
+ * or MatrixEdges) with how the pairs without an edge are weighted
+ * (NoCoordinates, HaversineCoordinates or PlanarCoordinates). The solvers are
+ * templates over the metric, so each combination gets its own instantiation
+ * with the weight lookups inlined, instead of deciding per lookup like
+ * DistanceOracle does. Data picks the instantiation once, when loading.
+ *
+ * Every metric (and DistanceOracle) provides:
+ * - getGraph() and getMatrix()
+ * - edge(v, u): the weight of the edge between v and u, if there is one
+ * - implicit(v, u): the weight of a pair without an edge
+ * - weight(v, u): edge(v, u), or implicit(v, u) if there is no edge
+ * - implicitKeys(v, out): keys of implicit(v, u) for every u, in the same
+ *   order as the weights (cheaper to compute)
+ * - forEachEdge(v, fn): calls fn(dest, weight, edgeId) for every edge leaving
+ *   v, until fn returns false
+ * - edgeId(v, u) and numEdgeIds(): ids of the undirected edges, in the range
+ *   [0, numEdgeIds())
+ */
+
+#include "CSRGraph.h"
+#include "DistanceKernel.h"
+#include "DistanceMatrix.h"
+#include "DistanceOracle.h"
+#include "Weight.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <optional>
+
+// Explicit edges ==============================================================
+
+/**
+ * @brief Explicit edges stored in the adjacency arrays of a CSRGraph
+ * @note edge(): O(log deg(v))
+ */
+class SparseEdges {
+public:
+  explicit SparseEdges(const CSRGraph &g) : g(&g) {}
+
+  [[nodiscard]] const DistanceMatrix *getMatrix() const { return nullptr; }
+
+  [[nodiscard]] std::optional<double> edge(uint32_t v, uint32_t u) const {
+    if (auto e = g->findEdge(v, u))
+      return g->getWeight(e.value());
+    return {};
+  }
+
+  template <typename F> void forEachEdge(uint32_t v, F fn) const {
+    for (uint64_t e = g->edgeBegin(v); e < g->edgeBegin(v + 1); ++e)
+      if (!fn(g->getDest(e), g->getWeight(e), g->getEdgeId(e)))
+        return;
+  }
+
+  [[nodiscard]] std::optional<uint64_t> edgeId(uint32_t v, uint32_t u) const {
+    if (auto e = g->findEdge(v, u))
+      return g->getEdgeId(e.value());
+    return {};
+  }
+
+  [[nodiscard]] uint64_t numEdgeIds() const { return g->getNumEdgeIds(); }
+
+private:
+  const CSRGraph *g;
+};
+
+/**
+ * @brief Explicit edges stored in a DistanceMatrix
+ * @details The id of an edge is its position in the upper triangle of the
+ * matrix.
+ * @note edge(): O(1)
+ */
+class MatrixEdges {
+public:
+  explicit MatrixEdges(const DistanceMatrix &m) : m(&m) {}
+
+  [[nodiscard]] const DistanceMatrix *getMatrix() const { return m; }
+
+  [[nodiscard]] std::optional<double> edge(uint32_t v, uint32_t u) const {
+    if (m->hasEdge(v, u))
+      return m->at(v, u);
+    return {};
+  }
+
+  template <typename F> void forEachEdge(uint32_t v, F fn) const {
+    const Weight *row = m->row(v);
+    for (uint32_t u = 0; u < m->size(); ++u)
+      if (u != v && row[u] != WeightTraits<Weight>::none &&
+          !fn(u, WeightTraits<Weight>::load(row[u]),
+              (uint64_t) std::min(u, v) * m->size() + std::max(u, v)))
+        return;
+  }
+
+  [[nodiscard]] std::optional<uint64_t> edgeId(uint32_t v, uint32_t u) const {
+    if (!m->hasEdge(v, u))
+      return {};
+    return (uint64_t) std::min(u, v) * m->size() + std::max(u, v);
+  }
+
+  [[nodiscard]] uint64_t numEdgeIds() const {
+    return (uint64_t) m->size() * m->size();
+  }
+
+private:
+  const DistanceMatrix *m;
+};
+
+// Implicit weights ============================================================
+
+/**
+ * @brief The pairs without an edge have no weight
+ * @throws std::bad_optional_access When asked for one, like a missing
+ * coordinate would
+ */
+class NoCoordinates {
+public:
+  [[nodiscard]] double implicit(uint32_t, uint32_t) const {
+    throw std::bad_optional_access();
+  }
+
+  void implicitKeys(uint32_t, double *) const {}
+};
+
+/**
+ * @brief Great-circle distance between the coordinates, memoized in a
+ * DistanceCache
+ * @details The keys are the squared chords between the unit vectors (see
+ * CSRGraph::chordRow()).
+ */
+class HaversineCoordinates {
+public:
+  explicit HaversineCoordinates(const CSRGraph &g, DistanceCache *cache)
+      : g(&g), cache(cache) {}
+
+  [[nodiscard]] double implicit(uint32_t v, uint32_t u) const {
+    if (auto d = cache->find(v, u))
+      return d.value();
+    double d = g->distance(v, u);
+    cache->store(v, u, d);
+    return d;
+  }
+
+  void implicitKeys(uint32_t v, double *out) const { g->chordRow(v, out); }
+
+private:
+  const CSRGraph *g;
+  DistanceCache *cache;
+};
+
+/**
+ * @brief Euclidean distance between planar coordinates
+ * @details The coordinates of nodes.csv are taken as (x, y). The keys are the
+ * squared distances.
+ * @throws std::bad_optional_access If a vertex has no coordinates
+ */
+class PlanarCoordinates {
+public:
+  explicit PlanarCoordinates(const CSRGraph &g) : g(&g) {}
+
+  [[nodiscard]] double implicit(uint32_t v, uint32_t u) const {
+    const Info &a = g->getInfo(v), &b = g->getInfo(u);
+    return std::hypot(a.getLat().value() - b.getLat().value(),
+                      a.getLon().value() - b.getLon().value());
+  }
+
+  /// @details NaN for the vertices without coordinates
+  void implicitKeys(uint32_t v, double *out) const {
+    constexpr double nan = std::numeric_limits<double>::quiet_NaN();
+    const Info &a = g->getInfo(v);
+    double x = a.getLat().value_or(nan), y = a.getLon().value_or(nan);
+    for (uint32_t u = 0; u < g->getNumVertex(); ++u) {
+      const Info &b = g->getInfo(u);
+      double dx = x - b.getLat().value_or(nan);
+      double dy = y - b.getLon().value_or(nan);
+      out[u] = dx * dx + dy * dy;
+    }
+  }
+
+private:
+  const CSRGraph *g;
+};
+
+// Metric ======================================================================
+
+/**
+ * @brief Weight between any two vertices, fixed at compile time
+ * @tparam Edges SparseEdges or MatrixEdges
+ * @tparam Implicit NoCoordinates, HaversineCoordinates or PlanarCoordinates
+ */
+template <typename Edges, typename Implicit>
+class Metric : public Edges, public Implicit {
+public:
+  Metric(const CSRGraph &g, Edges edges, Implicit implicit)
+      : Edges(edges), Implicit(implicit), g(&g) {}
+
+  [[nodiscard]] const CSRGraph &getGraph() const { return *g; }
+
+  [[nodiscard]] double weight(uint32_t v, uint32_t u) const {
+    if (auto w = this->edge(v, u))
+      return w.value();
+    return this->implicit(v, u);
+  }
+
+private:
+  const CSRGraph *g;
+};
+
+#endif // DA2324_PRJ2_G163_METRIC_HPP
@@ -0,0 +1,165 @@
+#include "Snapshot.h"
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <type_traits>
+
+/// Fixed-size header at the start of a snapshot
+struct SnapshotHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t byteOrder;  /// BYTE_ORDER_MARK, as written by the machine
+  uint32_t numVertex;
+  uint32_t numEdgeIds;
+  uint64_t numEntries; /// Number of adjacency entries
+  uint64_t checksum;   /// Checksum of the source csv files
+  uint32_t candidates; /// Edges kept per vertex when streaming (0 if all)
+  uint32_t reserved;
+};
+
+static_assert(sizeof(SnapshotHeader) == 48);
+
+static constexpr char MAGIC[8] = {'D', 'A', 'T', 'S', 'P', 'S', 'N', 'P'};
+static constexpr uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+/// Size of a section, padded so the next one starts at a multiple of 8 bytes
+static uint64_t padded(uint64_t bytes) { return (bytes + 7) & ~7ull; }
+
+/// Total size of a snapshot with the given header
+static uint64_t fileSize(const SnapshotHeader &h) {
+  uint64_t v = h.numVertex;
+  uint64_t e = h.numEntries;
+  return padded(sizeof(SnapshotHeader)) + 3 * padded(v * 8) +
+         padded((v + 1) * 8) + 2 * padded(e * 4) + padded(e * 8);
+}
+
+static void writeSection(std::ofstream &out, const void *data, uint64_t bytes) {
+  static constexpr char zeros[8] = {};
+  out.write(static_cast<const char *>(data), (std::streamsize) bytes);
+  out.write(zeros, (std::streamsize) (padded(bytes) - bytes));
+}
+
+uint64_t Snapshot::checksum(const std::vector<std::string> &paths) {
+  uint64_t hash = 0xcbf29ce484222325ull;
+  for (const std::string &path : paths) {
+    MappedFile file(path);
+    for (char c : file.view()) {
+      hash ^= (unsigned char) c;
+      hash *= 0x100000001b3ull;
+    }
+  }
+  return hash;
+}
+
+bool Snapshot::write(const std::string &path, const CSRGraph &g,
+                     const IdMap &ids, uint64_t checksum,
+                     uint32_t candidates) {
+  SnapshotHeader h{};
+  std::memcpy(h.magic, MAGIC, sizeof(MAGIC));
+  h.version = SNAPSHOT_VERSION;
+  h.byteOrder = BYTE_ORDER_MARK;
+  h.numVertex = g.getNumVertex();
+  h.numEdgeIds = g.getNumEdgeIds();
+  h.numEntries = g.getNumEdges();
+  h.checksum = checksum;
+  h.candidates = candidates;
+
+  // The weights are always written as doubles
+  std::vector<double> weights;
+  if constexpr (!std::is_same_v<Weight, double>)
+    for (Weight w : g.edgeWeights)
+      weights.push_back(WeightTraits<Weight>::load(w));
+
+  std::vector<uint64_t> origIds(h.numVertex);
+  std::vector<double> lat(h.numVertex), lon(h.numVertex);
+  for (uint32_t v = 0; v < h.numVertex; ++v) {
+    origIds[v] = ids.getId(v);
+    lat[v] = g.getInfo(v).getLat().value_or(std::numeric_limits<double>::quiet_NaN());
+    lon[v] = g.getInfo(v).getLon().value_or(std::numeric_limits<double>::quiet_NaN());
+  }
+
+  std::ofstream out(path, std::ios::out | std::ios::binary | std::ios::trunc);
+  writeSection(out, &h, sizeof(h));
+  writeSection(out, origIds.data(), origIds.size() * 8);
+  writeSection(out, lat.data(), lat.size() * 8);
+  writeSection(out, lon.data(), lon.size() * 8);
+  writeSection(out, g.offsets.data(), g.offsets.size_bytes());
+  writeSection(out, g.targets.data(), g.targets.size_bytes());
+  if constexpr (std::is_same_v<Weight, double>)
+    writeSection(out, g.edgeWeights.data(), g.edgeWeights.size_bytes());
+  else
+    writeSection(out, weights.data(), weights.size() * 8);
+  writeSection(out, g.edgeIds.data(), g.edgeIds.size_bytes());
+  return out.good();
+}
+
+bool Snapshot::read(const std::string &path, std::unique_ptr<MappedFile> &file,
+                    CSRGraph &g, IdMap &ids, uint64_t &checksum,
+                    uint32_t &candidates) {
+  file = std::make_unique<MappedFile>(path);
+  std::string_view data = file->view();
+  SnapshotHeader h{};
+  if (data.size() < sizeof(h))
+    return false;
+  std::memcpy(&h, data.data(), sizeof(h));
+  // Bound the sizes first, so fileSize() cannot overflow
+  if (std::memcmp(h.magic, MAGIC, sizeof(MAGIC)) != 0 ||
+      h.version != SNAPSHOT_VERSION || h.byteOrder != BYTE_ORDER_MARK ||
+      h.numVertex > data.size() / 32 || h.numEntries > data.size() / 16 ||
+      data.size() != fileSize(h))
+    return false;
+
+  uint64_t pos = padded(sizeof(h));
+  auto section = [&](uint64_t bytes) {
+    const char *start = data.data() + pos;
+    pos += padded(bytes);
+    return start;
+  };
+  uint32_t n = h.numVertex;
+  uint64_t e = h.numEntries;
+  auto origIds = reinterpret_cast<const uint64_t *>(section(n * 8ull));
+  auto lat = reinterpret_cast<const double *>(section(n * 8ull));
+  auto lon = reinterpret_cast<const double *>(section(n * 8ull));
+  g.offsets = {reinterpret_cast<const uint64_t *>(section((n + 1) * 8ull)),
+               n + 1ull};
+  g.targets = {reinterpret_cast<const uint32_t *>(section(e * 4)), e};
+  auto weights = reinterpret_cast<const double *>(section(e * 8));
+  if constexpr (std::is_same_v<Weight, double>) {
+    g.edgeWeights = {reinterpret_cast<const Weight *>(weights), e};
+  } else {
+    g.edgeWeightsData.resize(e);
+    for (uint64_t i = 0; i < e; ++i)
+      g.edgeWeightsData[i] = WeightTraits<Weight>::store(weights[i]);
+    g.edgeWeights = g.edgeWeightsData;
+  }
+  g.edgeIds = {reinterpret_cast<const uint32_t *>(section(e * 4)), e};
+  g.numEdgeIds = h.numEdgeIds;
+
+  // Every index must be in range, so the algorithms can trust the arrays
+  if (g.offsets.front() != 0 || g.offsets.back() != e)
+    return false;
+  for (uint32_t v = 0; v < n; ++v) {
+    if (g.offsets[v] > g.offsets[v + 1])
+      return false;
+    for (uint64_t i = g.offsets[v]; i < g.offsets[v + 1]; ++i)
+      if (g.targets[i] >= n || g.edgeIds[i] >= h.numEdgeIds ||
+          (i > g.offsets[v] && g.targets[i] <= g.targets[i - 1]))
+        return false; // rows are sorted by destination, without repeats
+  }
+
+  g.infos.clear();
+  g.infos.reserve(n);
+  for (uint32_t v = 0; v < n; ++v) {
+    if (ids.intern(origIds[v]) != v)
+      return false; // repeated id
+    if (std::isnan(lat[v]) || std::isnan(lon[v]))
+      g.infos.emplace_back(origIds[v]);
+    else
+      g.infos.emplace_back(origIds[v], lat[v], lon[v]);
+  }
+  g.buildUnitVectors();
+  checksum = h.checksum;
+  candidates = h.candidates;
+  return true;
+}
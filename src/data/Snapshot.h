@@ -0,0 +1,62 @@
+#ifndef DA2324_PRJ2_G163_SNAPSHOT_H
+#define DA2324_PRJ2_G163_SNAPSHOT_H
+
+#include "CSRGraph.h"
+#include "IdMap.h"
+#include "MappedFile.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+/// Version of the snapshot format, bumped on every incompatible change
+#define SNAPSHOT_VERSION 2
+
+/**
+ * @brief Binary snapshot of a loaded graph.
+ * @details The file holds everything the program needs after loading the
+ * csv files, laid out so it can be used straight from a memory mapping:
+ * - a header (magic, version, byte order, sizes, the checksum of the csv
+ *   files it was built from and the number of candidates kept per vertex);
+ * - the original id of every dense index;
+ * - the coordinates of every vertex (NaN when unknown);
+ * - the CSR arrays (offsets, targets, weights and edge ids).
+ * Every section starts at a multiple of 8 bytes. The byte order is the one of
+ * the machine that wrote the file, which is checked when reading it.
+ */
+class Snapshot {
+public:
+  /**
+   * @brief Checksum (64-bit FNV-1a) of the contents of the given files
+   * @note Time Complexity: O(n), where n is the total size of the files
+   */
+  static uint64_t checksum(const std::vector<std::string> &paths);
+
+  /**
+   * @brief Writes a snapshot of a graph
+   * @param checksum Checksum of the csv files the graph was loaded from
+   * @param candidates Number of edges kept per vertex, if the edges were
+   * streamed (0 otherwise)
+   * @return False if the file could not be written
+   */
+  static bool write(const std::string &path, const CSRGraph &g,
+                    const IdMap &ids, uint64_t checksum, uint32_t candidates);
+
+  /**
+   * @brief Maps a snapshot
+   * @details The arrays of the graph point into the mapping, so nothing is
+   * parsed or copied, besides rebuilding the vertex information and ids.
+   * The file is rejected unless its size matches the header and every offset,
+   * destination and edge id is in range (the rows sorted by destination).
+   * @note Time Complexity: O(V + E)
+   * @param file Receives the mapping, which must outlive the graph
+   * @param checksum Receives the checksum of the source csv files
+   * @param candidates Receives the number of edges kept per vertex
+   * @return False if the file is not a valid snapshot
+   */
+  static bool read(const std::string &path, std::unique_ptr<MappedFile> &file,
+                   CSRGraph &g, IdMap &ids, uint64_t &checksum,
+                   uint32_t &candidates);
+};
+
+#endif // DA2324_PRJ2_G163_SNAPSHOT_H
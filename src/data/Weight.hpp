@@ -0,0 +1,84 @@
+#ifndef DA2324_PRJ2_G163_WEIGHT_HPP
+#define DA2324_PRJ2_G163_WEIGHT_HPP
+
+/**
+ * @file Weight.hpp
+ * @brief Type the edge weights are stored as.
+ * @details The weights are always read, added and compared as doubles, but
+ * the graph, its snapshot and the distance matrix may store them with less
+ * precision to halve their memory: as floats, or as 32-bit fixed-point
+ * integers (rounded to the nearest multiple of 1 / WEIGHT_SCALE, like the
+ * TSPLIB integer distances). The type is chosen at compile time (see the
+ * WEIGHT_TYPE CMake option): define WEIGHT_FLOAT or WEIGHT_FIXED, or neither
+ * to keep doubles.
+ * Tour costs are still accumulated in doubles, so only the rounding of each
+ * weight is lost.
+ */
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+#ifndef INF
+#define INF std::numeric_limits<double>::max()
+#endif
+
+/// Number of fixed-point units per unit of weight (WEIGHT_FIXED only)
+#ifndef WEIGHT_SCALE
+#define WEIGHT_SCALE 1
+#endif
+
+/**
+ * @brief Conversions between a stored weight type and double.
+ * @details Every specialization provides:
+ * - none: the stored value of a missing edge, loaded back as INF
+ * - store(w): the stored value closest to the weight w
+ * - load(w): the value of a stored weight
+ * - name: a human readable name of the type
+ */
+template <typename W> struct WeightTraits;
+
+template <> struct WeightTraits<double> {
+  static constexpr const char *name = "double";
+  static constexpr double none = INF;
+
+  static constexpr double store(double w) { return w; }
+
+  static constexpr double load(double w) { return w; }
+};
+
+template <> struct WeightTraits<float> {
+  static constexpr const char *name = "float32";
+  static constexpr float none = std::numeric_limits<float>::max();
+
+  static constexpr float store(double w) {
+    return w >= none ? none : (float) w;
+  }
+
+  static constexpr double load(float w) { return w == none ? INF : w; }
+};
+
+template <> struct WeightTraits<int32_t> {
+  static constexpr const char *name = "int32 fixed-point";
+  static constexpr int32_t none = std::numeric_limits<int32_t>::max();
+
+  /// @note Weights that do not fit are clamped to the largest one
+  static int32_t store(double w) {
+    double scaled = std::round(w * WEIGHT_SCALE);
+    return scaled >= none ? none - 1 : (int32_t) scaled;
+  }
+
+  static constexpr double load(int32_t w) {
+    return w == none ? INF : (double) w / WEIGHT_SCALE;
+  }
+};
+
+#if defined(WEIGHT_FLOAT)
+typedef float Weight;
+#elif defined(WEIGHT_FIXED)
+typedef int32_t Weight;
+#else
+typedef double Weight;
+#endif
+
+#endif // DA2324_PRJ2_G163_WEIGHT_HPP
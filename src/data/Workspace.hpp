@@ -0,0 +1,116 @@
+#ifndef DA2324_PRJ2_G163_WORKSPACE_HPP
+#define DA2324_PRJ2_G163_WORKSPACE_HPP
+
+/**
+ * @file Workspace.hpp
+ * @brief Scratch state of a single algorithm run.
+ * @details The graph snapshot is shared and read-only, so everything an
+ * algorithm needs to mark while running lives here instead, stored as one
+ * array per field (indexed by dense vertex index). Each run owns its
+ * workspace, which allows several runs to share the same graph concurrently.
+ */
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#ifndef INF
+#define INF std::numeric_limits<double>::max()
+#endif
+
+struct Workspace {
+  std::vector<uint8_t> visited;    /// Used by traversal algorithms
+  std::vector<uint8_t> processing; /// Used by greedy algorithms
+  std::vector<double> dist;        /// Used by shortest path / MST algorithms
+  std::vector<uint32_t> path;      /// Predecessor (UINT32_MAX if none)
+  std::vector<uint32_t> queueIndex; /// Used by WorkspaceQueue (0 if not queued)
+  std::vector<double> flow;        /// Pheromones, indexed by edge slot
+  std::vector<double> row;         /// One-to-many distances, sized on demand
+
+  Workspace() = default;
+
+  /**
+   * @brief Allocates the per-vertex arrays for n vertices
+   */
+  explicit Workspace(uint32_t n)
+      : visited(n, false), processing(n, false), dist(n, INF),
+        path(n, UINT32_MAX), queueIndex(n, 0) {}
+
+  /**
+   * @brief Number of vertices covered by the workspace
+   */
+  [[nodiscard]] uint32_t size() const { return visited.size(); }
+};
+
+/**
+ * @brief Mutable min-priority queue of vertices, keyed by Workspace::dist.
+ * @details Equivalent to MutablePriorityQueue, but the heap positions are kept
+ * in Workspace::queueIndex instead of inside each vertex. Vertices at the same
+ * distance come out by increasing index.
+ */
+class WorkspaceQueue {
+public:
+  explicit WorkspaceQueue(Workspace &ws) : ws(ws) {
+    H.push_back(UINT32_MAX); // indices start at 1 to simplify the arithmetic
+  }
+
+  [[nodiscard]] bool empty() const { return H.size() == 1; }
+
+  void insert(uint32_t v) {
+    H.push_back(v);
+    heapifyUp(H.size() - 1);
+  }
+
+  uint32_t extractMin() {
+    uint32_t x = H[1];
+    H[1] = H.back();
+    H.pop_back();
+    if (H.size() > 1)
+      heapifyDown(1);
+    ws.queueIndex[x] = 0;
+    return x;
+  }
+
+  void decreaseKey(uint32_t v) { heapifyUp(ws.queueIndex[v]); }
+
+private:
+  Workspace &ws;
+  std::vector<uint32_t> H;
+
+  /// Ties go to the lowest index, like a linear scan for the minimum
+  bool less(uint32_t a, uint32_t b) const {
+    return ws.dist[a] < ws.dist[b] || (ws.dist[a] == ws.dist[b] && a < b);
+  }
+
+  void set(uint32_t i, uint32_t v) {
+    H[i] = v;
+    ws.queueIndex[v] = i;
+  }
+
+  void heapifyUp(uint32_t i) {
+    uint32_t x = H[i];
+    while (i > 1 && less(x, H[i / 2])) {
+      set(i, H[i / 2]);
+      i /= 2;
+    }
+    set(i, x);
+  }
+
+  void heapifyDown(uint32_t i) {
+    uint32_t x = H[i];
+    while (true) {
+      uint32_t k = i * 2;
+      if (k >= H.size())
+        break;
+      if (k + 1 < H.size() && less(H[k + 1], H[k]))
+        ++k; // right child of i
+      if (!less(H[k], x))
+        break;
+      set(i, H[k]);
+      i = k;
+    }
+    set(i, x);
+  }
+};
+
+#endif // DA2324_PRJ2_G163_WORKSPACE_HPP
@@ -0,0 +1,117 @@
+/**
+ * @file CandidateSetTest.cpp
+ * @brief Streaming the edges keeps the k lightest ones of every vertex.
+ * @details Covers the bounded heaps of CandidateSet, the union of the edges
+ * kept by either endpoint, and the blocks edges.csv is streamed in, whose
+ * partial last line is carried over to the next block.
+ */
+
+#include "../src/data/CandidateSet.h"
+#include "../src/data/Data.h"
+#include "TestUtils.hpp"
+#include <algorithm>
+#include <set>
+#include <sstream>
+#include <string>
+
+/// Destinations kept for a vertex, sorted
+static std::vector<uint32_t> kept(const CandidateSet &set, uint32_t v) {
+  std::vector<uint32_t> res;
+  for (const Candidate &c : set.get(v))
+    res.push_back(c.dest);
+  std::sort(res.begin(), res.end());
+  return res;
+}
+
+/// Weight kept for an edge, or -1 if it is not a candidate
+static double weightOf(const CandidateSet &set, uint32_t v, uint32_t u) {
+  for (const Candidate &c : set.get(v))
+    if (c.dest == u)
+      return c.weight;
+  return -1;
+}
+
+int main() {
+  // The heaviest edge is evicted once there are k
+  CandidateSet evict(2);
+  evict.add(0, 1, 5);
+  evict.add(0, 2, 3);
+  evict.add(0, 3, 1);
+  CHECK((kept(evict, 0) == std::vector<uint32_t>{2, 3}));
+  evict.add(0, 4, 9); // heavier than every candidate: ignored by 0
+  CHECK((kept(evict, 0) == std::vector<uint32_t>{2, 3}));
+  CHECK((kept(evict, 4) == std::vector<uint32_t>{0}));
+  evict.add(2, 2, 0); // self-loops are not candidates
+  CHECK(!evict.contains(2, 2));
+
+  // A repeated pair keeps its lightest weight, and the heap is rebuilt, so
+  // the next eviction still drops the heaviest
+  CandidateSet repeat(2);
+  repeat.add(0, 1, 5);
+  repeat.add(0, 2, 4);
+  repeat.add(1, 0, 2); // 0-1 was the heaviest, now the lightest
+  repeat.add(0, 1, 8); // heavier repeat: ignored
+  CHECK(weightOf(repeat, 0, 1) == 2);
+  CHECK(weightOf(repeat, 1, 0) == 2);
+  repeat.add(0, 3, 3);
+  CHECK((kept(repeat, 0) == std::vector<uint32_t>{1, 3}));
+
+  // The union visits every edge kept by either endpoint once
+  const uint32_t n = 12;
+  std::vector<TestEdge> edges;
+  for (uint32_t i = 0; i < n; ++i)
+    for (uint32_t j = i + 1; j < n; ++j)
+      edges.push_back({i, j, 1.0 + (i * 17 + j * 29) % 23});
+  CandidateSet set(3);
+  for (const TestEdge &e : edges)
+    set.add(e.orig, e.dest, e.weight);
+  std::set<std::pair<uint32_t, uint32_t>> visited;
+  uint64_t visits = 0;
+  set.forEachEdge([&](uint32_t v, uint32_t u, double weight) {
+    ++visits;
+    visited.insert({std::min(v, u), std::max(v, u)});
+    CHECK(set.contains(v, u) || set.contains(u, v));
+    CHECK(weight == 1.0 + (std::min(v, u) * 17 + std::max(v, u) * 29) % 23);
+  });
+  CHECK(visits == visited.size());
+  CHECK(set.getNumEdges() == visits);
+  for (uint32_t v = 0; v < n; ++v)
+    for (const Candidate &c : set.get(v))
+      CHECK(visited.count({std::min(v, c.dest), std::max(v, c.dest)}) == 1);
+
+  // Streaming in blocks gives the same lines as reading the whole buffer,
+  // whatever the block size
+  std::string text = "\xEF\xBB\xBF"
+                     "origem,destino,distancia\r\n0,1,10\n\n1,2,20.5\r\n"
+                     "2,3,30\n3,0,40";
+  std::vector<std::string> whole;
+  CsvTokenizer tokenizer(text);
+  std::string_view line;
+  while (tokenizer.next_line(line))
+    whole.emplace_back(line);
+  for (size_t block = 1; block <= text.size() + 1; ++block) {
+    std::istringstream in(text);
+    std::vector<std::string> lines;
+    uint64_t last = 0;
+    CsvTokenizer::for_each_line(in, block,
+                                [&](std::string_view l, uint64_t offset) {
+                                  lines.emplace_back(l);
+                                  CHECK(offset >= last);
+                                  last = offset;
+                                });
+    CHECK(lines == whole);
+    CHECK(last == text.size());
+  }
+
+  // Data keeps the same candidates, and with k = n - 1 the whole graph
+  std::filesystem::path dir = tempDir("CandidateSetTest");
+  std::filesystem::path path = dir / "edges.csv";
+  writeEdges(path, edges);
+  Data candidates(path.string(), 1, 3);
+  CHECK(candidates.getCSR().getNumEdgeIds() == set.getNumEdges());
+  Data all(path.string(), 1, n - 1), full(path.string());
+  CHECK(all.getCSR().getNumEdgeIds() == full.getCSR().getNumEdgeIds());
+  CHECK(all.heuristic().cost == full.heuristic().cost);
+
+  return finish(dir);
+}
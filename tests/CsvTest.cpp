@@ -0,0 +1,58 @@
+/**
+ * @file CsvTest.cpp
+ * @brief The typed CsvReader reads the lines of edges.csv into its columns.
+ * @details Covers the lines split by hand, the ones handed to the csv grammar
+ * (headers and quoted numbers) and the ones that do not match the schema.
+ */
+
+#include "../src/CSV.hpp"
+#include "TestUtils.hpp"
+#include <string>
+
+typedef CsvReader<uint32_t, uint32_t, double> Reader;
+
+int main() {
+  std::string text = "\xEF\xBB\xBF"
+                     "origem,destino,distancia\r\n" // header, CRLF
+                     "0,1,2.5\r\n"                  // CRLF
+                     "\n"                           // empty line, skipped
+                     "1,\"12,5\",7.5\n"             // quoted number
+                     "2,3\n"                        // shorter than the schema
+                     "3,4,1.25,label,9\n"           // extra columns
+                     "4,x,1\n"                      // not a number
+                     "5,6,-3";                      // no final line break
+  Reader reader(text);
+
+  CHECK(reader.next() == Reader::Mismatch);
+  CHECK(reader.next() == Reader::Row);
+  CHECK(reader.next() == Reader::Row);
+  CHECK(reader.next() == Reader::Mismatch);
+  CHECK(reader.next() == Reader::Row);
+  CHECK(reader.next() == Reader::Mismatch);
+  CHECK(reader.next() == Reader::Row);
+  CHECK(reader.next() == Reader::End);
+  CHECK(reader.next() == Reader::End);
+  CHECK(reader.offset() == text.size());
+
+  CHECK(reader.size() == 4);
+  if (reader.size() == 4) {
+    // "12,5" is the weird format of the quoted numbers: 12 * 10 + 5
+    CHECK((reader.column<0>() == std::vector<uint32_t>{0, 1, 3, 5}));
+    CHECK((reader.column<1>() == std::vector<uint32_t>{1, 125, 4, 6}));
+    CHECK((reader.column<2>() == std::vector<double>{2.5, 7.5, 1.25, -3}));
+  }
+
+  // A row is converted without being stored
+  Reader::row_type row;
+  CHECK(Reader::parse_row("7,8,9", row));
+  CHECK(row == Reader::row_type(7, 8, 9.0));
+  CHECK(!Reader::parse_row("7,8", row));
+  CHECK(!Reader::parse_row("", row));
+
+  // An empty buffer has no lines
+  Reader empty;
+  CHECK(empty.next() == Reader::End);
+  CHECK(empty.size() == 0);
+
+  return finish();
+}
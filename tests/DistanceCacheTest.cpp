@@ -0,0 +1,67 @@
+/**
+ * @file DistanceCacheTest.cpp
+ * @brief The DistanceCache never returns the distance of another pair.
+ * @details Several threads store and look up pairs that collide on a tiny
+ * table, where every distance is a function of its pair, so any hit can be
+ * checked.
+ */
+
+#include "../src/data/DistanceOracle.h"
+#include "TestUtils.hpp"
+#include <thread>
+
+/// Distance stored for a pair, distinct for every unordered pair
+static double distanceOf(uint32_t v, uint32_t u) {
+  return std::min(v, u) * 1000.0 + std::max(v, u);
+}
+
+int main() {
+  // Pairs that hit the same slot, stored back to back
+  DistanceCache single(4);
+  single.store(1, 2, distanceOf(1, 2));
+  CHECK(single.find(2, 1) == distanceOf(1, 2));
+  CHECK(!single.find(1, 3).has_value());
+  for (uint32_t v = 0; v < 64; ++v)
+    single.store(v, v + 1, distanceOf(v, v + 1));
+  for (uint32_t v = 0; v < 64; ++v)
+    if (auto d = single.find(v, v + 1))
+      CHECK(d.value() == distanceOf(v, v + 1));
+
+  // 2 slots shared by every pair of 8 vertices and 8 threads, so writers
+  // often overlap (even on a single core, when they are preempted)
+  DistanceCache cache(1);
+  const unsigned threads = 8;
+  const uint32_t rounds = 2000000;
+  std::vector<uint64_t> wrong(threads, 0), hits(threads, 0);
+  std::vector<std::thread> workers;
+  for (unsigned t = 0; t < threads; ++t)
+    workers.emplace_back([&, t] {
+      uint64_t state = t + 1;
+      for (uint32_t i = 0; i < rounds; ++i) {
+        state = state * 6364136223846793005ull + 1442695040888963407ull;
+        uint32_t v = (state >> 33) % 8, u = (state >> 45) % 8;
+        if (i % 2 == 0) {
+          cache.store(v, u, distanceOf(v, u));
+        } else if (auto d = cache.find(v, u)) {
+          ++hits[t];
+          if (d.value() != distanceOf(v, u))
+            ++wrong[t];
+        }
+      }
+    });
+  for (std::thread &worker : workers)
+    worker.join();
+
+  uint64_t totalWrong = 0, totalHits = 0;
+  for (unsigned t = 0; t < threads; ++t) {
+    totalWrong += wrong[t];
+    totalHits += hits[t];
+  }
+  CHECK(totalWrong == 0);
+  CHECK(totalHits > 0);
+  DistanceCache::Stats stats = cache.getStats();
+  CHECK(stats.hits == totalHits);
+  CHECK(stats.hits + stats.misses == (uint64_t) threads * rounds / 2);
+
+  return finish();
+}
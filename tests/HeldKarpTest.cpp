@@ -0,0 +1,91 @@
+/**
+ * @file HeldKarpTest.cpp
+ * @brief Held-Karp finds the same optimum as the backtracking.
+ * @details Solves small complete and sparse graphs both ways, checks that
+ * several threads give the same tour as one, and checks the graphs Held-Karp
+ * refuses: over the memory budget or over its vertex limit.
+ */
+
+#include "../src/data/Data.h"
+#include "TestUtils.hpp"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+/// Whether a path is a tour of the n vertices from vertex 0
+static bool isTour(const std::vector<uint64_t> &path, uint32_t n) {
+  if (path.size() != n + 1 || path.front() != 0 || path.back() != 0)
+    return false;
+  std::vector<uint64_t> sorted(path.begin(), path.end() - 1);
+  std::sort(sorted.begin(), sorted.end());
+  for (uint32_t i = 0; i < n; ++i)
+    if (sorted[i] != i)
+      return false;
+  return true;
+}
+
+/// Solves a graph both ways
+static void compare(const Data &d, uint32_t n) {
+  TSPResult exact = d.backtracking();
+  std::optional<TSPResult> hk = d.heldKarp(UINT64_MAX);
+  CHECK(hk.has_value());
+  if (!hk)
+    return;
+  if (exact.cost == DBL_MAX) { // No tour at all
+    CHECK(hk->cost == DBL_MAX);
+    return;
+  }
+  // The costs are compared as floats, so a tour within a float rounding of
+  // the optimum may be taken for it
+  CHECK(std::abs(hk->cost - exact.cost) <= exact.cost * 1e-6);
+  CHECK(isTour(hk->path, n));
+}
+
+int main() {
+  std::filesystem::path dir = tempDir("HeldKarpTest");
+  std::filesystem::path edges = dir / "edges.csv", nodes = dir / "nodes.csv";
+
+  for (uint32_t n : {2u, 3u, 6u, 9u, 11u})
+    for (double density : {1.0, 0.4})
+      for (uint32_t seed : {1u, 2u, 3u}) {
+        writeRandomGraph(edges, nodes, n, 1000, density, seed * 31 + n);
+        compare(Data(edges.string()), n);
+      }
+
+  // A graph over the budget is refused, and one just within it is solved
+  writeRandomGraph(edges, nodes, 10, 1000, 1.0, 5);
+  Data d(edges.string());
+  uint64_t needed = HeldKarp::memory(10);
+  CHECK(!d.heldKarp(needed - 1).has_value());
+  CHECK(d.heldKarp(needed).has_value());
+
+  // With 18 vertices, the largest layers have (17 choose 8) subsets, more
+  // than a thread takes, so they are split among the threads
+  uint64_t largest = 1;
+  for (uint32_t k = 1; k <= 8; ++k)
+    largest = largest * (17 - k + 1) / k;
+  CHECK(largest >= 4 * HELD_KARP_CHUNK);
+  for (double density : {1.0, 0.5}) {
+    writeRandomGraph(edges, nodes, 18, 1000, density, 18);
+    Data big(edges.string());
+    big.setThreads(1);
+    std::optional<TSPResult> single = big.heldKarp(UINT64_MAX);
+    big.setThreads(4);
+    std::optional<TSPResult> parallel = big.heldKarp(UINT64_MAX);
+    CHECK(single.has_value() && parallel.has_value());
+    if (single && parallel) {
+      CHECK(single->cost == parallel->cost);
+      CHECK(single->path == parallel->path);
+      CHECK(isTour(parallel->path, 18));
+    }
+  }
+
+  // Over 64 vertices the subsets do not fit in 64-bit masks
+  std::vector<TestEdge> path;
+  for (uint32_t v = 0; v + 1 < HELD_KARP_MAX_VERTICES + 1; ++v)
+    path.push_back({v, v + 1, 1});
+  writeEdges(edges, path);
+  CHECK(!Data(edges.string()).heldKarp(UINT64_MAX).has_value());
+
+  return finish(dir);
+}
@@ -0,0 +1,63 @@
+/**
+ * @file MetricTest.cpp
+ * @brief The solvers give the same tours with the Metric picked for the graph
+ * and with the DistanceOracle.
+ * @details Writes sparse graphs with planar coordinates (and, for reference,
+ * with latitudes and longitudes) and runs every solver both ways.
+ */
+
+#include "../src/data/Data.h"
+#include "TestUtils.hpp"
+
+static void checkSame(const TSPResult &a, const TSPResult &b) {
+  CHECK(a.cost == b.cost);
+  CHECK(a.path == b.path);
+}
+
+/// Runs every solver with the oracle and with the metric
+static void compare(Data &d, bool exact) {
+  d.setSpecialized(false);
+  TSPResult triangular = d.triangular(), heuristic = d.heuristic();
+  d.setSpecialized(true);
+  checkSame(triangular, d.triangular());
+  checkSame(heuristic, d.heuristic());
+  if (exact) {
+    d.setSpecialized(false);
+    TSPResult backtracking = d.backtracking();
+    d.setSpecialized(true);
+    checkSame(backtracking, d.backtracking());
+  }
+}
+
+int main() {
+  std::filesystem::path dir = tempDir("MetricTest");
+  std::filesystem::path edges = dir / "edges.csv", nodes = dir / "nodes.csv";
+
+  // Planar coordinates, far out of range for latitudes and longitudes
+  for (auto [n, exact] : {std::pair{9u, true}, std::pair{200u, false}}) {
+    writeRandomGraph(edges, nodes, n, 5000, 0.3, n);
+    Data d(edges.string(), nodes.string());
+    CHECK(d.getImplicitMetric() == ImplicitMetric::Haversine);
+    d.setPlanar(true);
+    CHECK(d.getImplicitMetric() == ImplicitMetric::Euclidean);
+    compare(d, exact);
+  }
+
+  // Latitudes and longitudes
+  writeRandomGraph(edges, nodes, 200, 80, 0.3, 7);
+  Data d(edges.string(), nodes.string());
+  CHECK(d.getImplicitMetric() == ImplicitMetric::Haversine);
+  compare(d, false);
+
+  // As many adjacency entries as a complete graph, but with self-loops in
+  // place of the edge between 0 and 3
+  writeEdges(edges, {{0, 1, 10}, {0, 2, 20}, {1, 2, 30}, {1, 3, 40},
+                     {2, 3, 50}, {1, 1, 0}, {2, 2, 0}});
+  writeNodes(nodes, {{1, 40}, {2, 41}, {3, 40}, {2, 39}});
+  Data loops(edges.string(), nodes.string());
+  CHECK(!loops.getCSR().isComplete());
+  CHECK(loops.getImplicitMetric() == ImplicitMetric::Haversine);
+  compare(loops, true);
+
+  return finish(dir);
+}
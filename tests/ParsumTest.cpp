@@ -0,0 +1,59 @@
+/**
+ * @file ParsumTest.cpp
+ * @brief Alternatives only skip the branches that cannot succeed.
+ * @details Runs alternatives whose first branch is chosen by its FirstSet on
+ * exhausted inputs and in front of contexts that change the error kind, and
+ * checks that labels keep the FirstSet of the csv fields.
+ */
+
+#include "../src/CSV.hpp"
+#include "../src/Parsum.hpp"
+#include "TestUtils.hpp"
+#include <sstream>
+
+using namespace parsum;
+
+int main() {
+  constexpr auto a_or_end = map(char_p('a'), [](char) { return 1; }) |
+                            map(eof(), [](std::tuple<>) { return 0; });
+
+  // The end of a stream is the end of the input, even before a read fails
+  std::istringstream empty("");
+  StreamInput exhausted(empty);
+  CHECK(next_char(exhausted) == CharSet::END);
+  auto res = a_or_end.to_fn()(exhausted);
+  CHECK(res.has_val && res.ok == 0);
+
+  std::istringstream one("a");
+  StreamInput stream(one);
+  res = a_or_end.to_fn()(stream);
+  CHECK(res.has_val && res.ok == 1);
+  res = a_or_end.to_fn()(stream);
+  CHECK(res.has_val && res.ok == 0);
+
+  StringInput string("");
+  res = a_or_end.to_fn()(string);
+  CHECK(res.has_val && res.ok == 0);
+
+  // A context that makes every failure irrecoverable stops the alternative,
+  // whatever the next char is
+  constexpr auto committed =
+      context(char_p('a'),
+              [](ParseError err) {
+                return err.with_kind(ParseError::ErrorVariant::Irrecoverable);
+              }) |
+      char_p('b');
+  StringInput b("b");
+  auto res2 = committed.to_fn()(b);
+  CHECK(!res2.has_val &&
+        res2.err.get_kind() == ParseError::ErrorVariant::Irrecoverable);
+
+  // Labels keep the FirstSet, so the csv fields are still dispatched by their
+  // first char
+  CHECK(!parse_flt().first().viable().test('a'));
+  CHECK(!parse_int().first().viable().test('"'));
+  CHECK(parse_str().first().viable().test('a'));
+  CHECK(!label(char_p('a'), "a").first().viable().test('b'));
+
+  return finish();
+}
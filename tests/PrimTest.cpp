@@ -0,0 +1,41 @@
+/**
+ * @file PrimTest.cpp
+ * @brief Both variants of Prim's algorithm build the same tree.
+ * @details Writes a dense graph whose weights tie often, with self-loops, and
+ * checks that the heap and the linear scan pick the same edges.
+ */
+
+#include "../src/Utils.h"
+#include "../src/data/Data.h"
+#include "TestUtils.hpp"
+
+int main() {
+  std::filesystem::path dir = tempDir("PrimTest");
+  std::filesystem::path edges = dir / "edges.csv";
+
+  // Complete graph of 60 vertices with weights from 1 to 3, and a self-loop
+  // lighter than every edge on each vertex
+  const uint32_t n = 60;
+  std::vector<TestEdge> list;
+  for (uint32_t i = 0; i < n; ++i) {
+    list.push_back({i, i, 0.5});
+    for (uint32_t j = i + 1; j < n; ++j)
+      list.push_back({i, j, 1.0 + (i * 7 + j * 13) % 3});
+  }
+  writeEdges(edges, list);
+  Data d(edges.string());
+  const CSRGraph &g = d.getCSR();
+  DistanceMatrix m(g);
+  for (uint32_t v = 0; v < n; ++v)
+    CHECK(m.at(v, v) == 0);
+
+  for (uint32_t start : {0u, 17u, n - 1}) {
+    Workspace heap(n), scan(n);
+    Utils::prim(g, start, heap);
+    Utils::prim(m, start, scan);
+    CHECK(heap.path == scan.path);
+    CHECK(heap.dist == scan.dist);
+  }
+
+  return finish(dir);
+}
@@ -0,0 +1,82 @@
+/**
+ * @file SnapshotTest.cpp
+ * @brief Snapshots round-trip, and truncated or corrupt ones are rejected.
+ * @details Writes a small graph to a snapshot, then damages copies of it one
+ * field at a time and checks that Data::fromSnapshot() refuses every one.
+ */
+
+#include "../src/data/Data.h"
+#include "TestUtils.hpp"
+#include <cstring>
+#include <iterator>
+#include <string>
+
+static std::string readFile(const std::filesystem::path &path) {
+  std::ifstream in(path, std::ios::binary);
+  return {std::istreambuf_iterator<char>(in), {}};
+}
+
+static void writeFile(const std::filesystem::path &path,
+                      const std::string &bytes) {
+  std::ofstream(path, std::ios::binary | std::ios::trunc) << bytes;
+}
+
+/// Copy of the snapshot with a value overwritten at a byte position
+template <typename T>
+static std::string patched(std::string bytes, uint64_t pos, T value) {
+  std::memcpy(bytes.data() + pos, &value, sizeof(value));
+  return bytes;
+}
+
+int main() {
+  std::filesystem::path dir = tempDir("SnapshotTest");
+  std::filesystem::path edges = dir / "edges.csv", snap = dir / "graph.snap",
+                        bad = dir / "bad.snap";
+
+  // 4 vertices and 4 edges: 8 adjacency entries
+  writeEdges(edges, {{0, 1, 10}, {1, 2, 20}, {2, 3, 30}, {3, 0, 40}});
+  Data d(edges.string());
+  CHECK(d.writeSnapshot(snap.string(), 0x1234));
+  uint64_t checksum = 0;
+  std::optional<Data> read = Data::fromSnapshot(snap.string(), &checksum);
+  CHECK(read.has_value());
+  CHECK(checksum == 0x1234);
+  if (read)
+    CHECK(read->backtracking().cost == d.backtracking().cost);
+
+  // The number of candidates survives the round trip
+  Data streamed(edges.string(), 1, 2);
+  CHECK(streamed.writeSnapshot(snap.string(), 0));
+  read = Data::fromSnapshot(snap.string());
+  CHECK(read.has_value() && read->getCandidates() == 2);
+  read.reset(); // unmap it before overwriting it
+  CHECK(d.writeSnapshot(snap.string(), 0));
+
+  // Layout of the file (see Snapshot.h), with n = 4 and e = 8
+  std::string bytes = readFile(snap);
+  const uint64_t n = 4, e = 8, header = 48;
+  const uint64_t offsets = header + 3 * n * 8;
+  const uint64_t targets = offsets + (n + 1) * 8;
+  const uint64_t edgeIds = targets + e * 4 + e * 8;
+  CHECK(bytes.size() == edgeIds + e * 4);
+
+  std::vector<std::pair<const char *, std::string>> corrupt = {
+      {"truncated", bytes.substr(0, bytes.size() - 8)},
+      {"extended", bytes + std::string(8, '\0')},
+      {"huge entry count", patched<uint64_t>(bytes, 24, 1ull << 61)},
+      {"decreasing offsets", patched<uint64_t>(bytes, offsets + 8 * 2, 1)},
+      {"offsets past the end", patched<uint64_t>(bytes, offsets + 8 * 4, 9)},
+      {"destination out of range", patched<uint32_t>(bytes, targets, 4)},
+      {"unsorted row", patched<uint32_t>(bytes, targets, 3)},
+      {"edge id out of range", patched<uint32_t>(bytes, edgeIds, 4)},
+  };
+  for (auto &[name, contents] : corrupt) {
+    writeFile(bad, contents);
+    if (Data::fromSnapshot(bad.string()).has_value()) {
+      std::cerr << "accepted a snapshot with " << name << "\n";
+      ++failures;
+    }
+  }
+
+  return finish(dir);
+}
@@ -0,0 +1,112 @@
+#ifndef DA2324_PRJ2_G163_TESTUTILS_HPP
+#define DA2324_PRJ2_G163_TESTUTILS_HPP
+
+/**
+ * @file TestUtils.hpp
+ * @brief Scaffolding shared by the tests in tests/.
+ * @details Each test is a plain executable: CHECK() counts the failed
+ * conditions, and finish() turns the count into the exit code. The graphs are
+ * written as csv files into a temporary directory of the test.
+ */
+
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+/// Number of failed checks so far
+inline int failures = 0;
+
+#define CHECK(cond)                                                            \
+  do {                                                                         \
+    if (!(cond)) {                                                             \
+      std::cerr << __FILE__ << ":" << __LINE__ << ": " #cond "\n";             \
+      ++failures;                                                              \
+    }                                                                          \
+  } while (0)
+
+/// An edge of a csv file
+struct TestEdge {
+  uint32_t orig;
+  uint32_t dest;
+  double weight;
+};
+
+/**
+ * @brief Creates an empty temporary directory for a test
+ */
+inline std::filesystem::path tempDir(const char *name) {
+  std::filesystem::path dir = std::filesystem::temp_directory_path() / name;
+  std::filesystem::remove_all(dir);
+  std::filesystem::create_directories(dir);
+  return dir;
+}
+
+/**
+ * @brief Writes an edges csv file, with its header
+ */
+inline void writeEdges(const std::filesystem::path &path,
+                       const std::vector<TestEdge> &edges) {
+  std::ofstream e(path);
+  e << "origem,destino,distancia\n";
+  for (const TestEdge &edge : edges)
+    e << edge.orig << "," << edge.dest << "," << edge.weight << "\n";
+}
+
+/**
+ * @brief Writes a nodes csv file, with its header
+ * @param coordinates The (longitude, latitude) of every vertex, by id
+ */
+inline void writeNodes(const std::filesystem::path &path,
+                       const std::vector<std::pair<double, double>> &coordinates) {
+  std::ofstream v(path);
+  v << "id,longitude,latitude\n";
+  for (size_t i = 0; i < coordinates.size(); ++i)
+    v << i << "," << coordinates[i].first << "," << coordinates[i].second
+      << "\n";
+}
+
+/**
+ * @brief Writes a graph of n vertices with about density of the pairs as
+ * edges, and coordinates from 0 to scale
+ * @details The path 0, 1, ..., n - 1 is always there, so the graph is
+ * connected. The same seed gives the same graph anywhere.
+ */
+inline void writeRandomGraph(const std::filesystem::path &edges,
+                             const std::filesystem::path &nodes, uint32_t n,
+                             double scale, double density, uint32_t seed) {
+  uint64_t state = seed;
+  auto random = [&] { // Knuth's MMIX LCG
+    state = state * 6364136223846793005ull + 1442695040888963407ull;
+    return (double) (state >> 11) / (double) (1ull << 53);
+  };
+  std::vector<std::pair<double, double>> coordinates;
+  for (uint32_t i = 0; i < n; ++i) {
+    double x = random() * scale;
+    coordinates.emplace_back(x, random() * scale / 2);
+  }
+  std::vector<TestEdge> list;
+  for (uint32_t i = 0; i < n; ++i)
+    for (uint32_t j = i + 1; j < n; ++j)
+      if (j == i + 1 || random() < density)
+        list.push_back({i, j, 1 + random() * scale});
+  writeEdges(edges, list);
+  writeNodes(nodes, coordinates);
+}
+
+/**
+ * @brief Removes the temporary directory and reports the failed checks
+ * @return The exit code of the test
+ */
+inline int finish(const std::filesystem::path &dir = {}) {
+  if (!dir.empty())
+    std::filesystem::remove_all(dir);
+  if (failures)
+    std::cerr << failures << " checks failed\n";
+  return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+#endif // DA2324_PRJ2_G163_TESTUTILS_HPP